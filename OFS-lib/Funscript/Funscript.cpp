@@ -10,6 +10,8 @@
 #include <limits>
 #include <set>
 
+uint32_t Funscript::ActionsVersionCounter = 0;
+
 Funscript::Funscript() 
 {
 	NotifyActionsChanged(false);
@@ -49,6 +51,7 @@ void Funscript::setScriptTemplate() noexcept
 void Funscript::NotifySelectionChanged() noexcept
 {
 	selectionChanged = true;
+	selectionVersion = ++ActionsVersionCounter;
 }
 
 void Funscript::loadMetadata() noexcept
@@ -98,6 +101,8 @@ void Funscript::update() noexcept
 		SDL_Event ev;
 		ev.type = FunscriptEvents::FunscriptActionsChangedEvent;
 		SDL_PushEvent(&ev);
+		lastChange = pendingChange;
+		pendingChange = ChangedInterval();
 
 		// TODO: find out how expensive this is on an already sorted array
 		sortActions(data.Actions);
@@ -255,7 +260,7 @@ void Funscript::AddActionSafe(FunscriptAction newAction) noexcept
 		});
 	if (safety == data.Actions.end()) {
 		data.Actions.insert(it, newAction);
-		NotifyActionsChanged(true);
+		NotifyActionsChanged(true, newAction.at, newAction.at);
 	}
 	else
 	{
@@ -271,7 +276,7 @@ bool Funscript::EditAction(FunscriptAction oldAction, FunscriptAction newAction)
 		act->at = newAction.at;
 		act->pos = newAction.pos;
 		checkForInvalidatedActions();
-		NotifyActionsChanged(true);
+		NotifyActionsChanged(true, std::min(oldAction.at, newAction.at), std::max(oldAction.at, newAction.at));
 		return true;
 	}
 	return false;
@@ -281,6 +286,7 @@ void Funscript::AddEditAction(FunscriptAction action, float frameTimeMs) noexcep
 {
 	auto close = getActionAtTime(data.Actions, action.at, frameTimeMs);
 	if (close != nullptr) {
+		NotifyActionsChanged(true, std::min(close->at, action.at), std::max(close->at, action.at));
 		*close = action;
 	}
 	else {
@@ -295,7 +301,6 @@ void Funscript::PasteAction(FunscriptAction paste, int32_t error_ms) noexcept
 		RemoveAction(*act);
 	}
 	AddAction(paste);
-	NotifyActionsChanged(true);
 }
 
 void Funscript::checkForInvalidatedActions() noexcept
@@ -317,7 +322,7 @@ void Funscript::RemoveAction(FunscriptAction action, bool checkInvalidSelection)
 	auto it = std::find(data.Actions.begin(), data.Actions.end(), action);
 	if (it != data.Actions.end()) {
 		data.Actions.erase(it);
-		NotifyActionsChanged(true);
+		NotifyActionsChanged(true, action.at, action.at);
 
 		if (checkInvalidSelection) { checkForInvalidatedActions(); }
 	}
@@ -325,9 +330,9 @@ void Funscript::RemoveAction(FunscriptAction action, bool checkInvalidSelection)
 
 void Funscript::RemoveActions(const std::vector<FunscriptAction>& removeActions) noexcept
 {
+	// RemoveAction reports the time of every removed action
 	for (auto&& action : removeActions)
 		RemoveAction(action, false);
-	NotifyActionsChanged(true);
 }
 
 std::vector<FunscriptAction> Funscript::GetLastStroke(int32_t time_ms) noexcept
@@ -379,6 +384,29 @@ std::vector<FunscriptAction> Funscript::GetLastStroke(int32_t time_ms) noexcept
 	return stroke;
 }
 
+void Funscript::rollback(const FunscriptData& rollbackData) noexcept
+{
+	// only the range between the common prefix & suffix changed
+	auto& current = data.Actions;
+	auto& target = rollbackData.Actions;
+	size_t prefix = 0;
+	size_t maxCommon = std::min(current.size(), target.size());
+	while (prefix < maxCommon && current[prefix] == target[prefix]) { prefix++; }
+	size_t suffix = 0;
+	while (suffix < maxCommon - prefix
+		&& current[current.size() - 1 - suffix] == target[target.size() - 1 - suffix]) {
+		suffix++;
+	}
+
+	ChangedInterval changed;
+	for (size_t i = prefix; i < current.size() - suffix; i++) { changed.Extend(current[i].at, current[i].at); }
+	for (size_t i = prefix; i < target.size() - suffix; i++) { changed.Extend(target[i].at, target[i].at); }
+
+	this->data = rollbackData;
+	// the interval stays empty if only the selection differs
+	NotifyActionsChanged(true, changed.fromMs, changed.toMs);
+}
+
 void Funscript::SetActions(const std::vector<FunscriptAction>& override_with) noexcept
 {
 	data.Actions.clear();
@@ -396,7 +424,7 @@ void Funscript::RemoveActionsInInterval(int32_t fromMs, int32_t toMs) noexcept
 			}), data.Actions.end()
 	);
 	checkForInvalidatedActions();
-	NotifyActionsChanged(true);
+	NotifyActionsChanged(true, fromMs, toMs);
 }
 
 void Funscript::RangeExtendSelection(int32_t rangeExtend) noexcept
@@ -635,20 +663,24 @@ void Funscript::RemoveSelectedActions() noexcept
 void Funscript::moveActionsTime(std::vector<FunscriptAction*> moving, int32_t time_offset)
 {
 	ClearSelection();
+	ChangedInterval changed;
 	for (auto move : moving) {
+		changed.Extend(std::min(move->at, move->at + time_offset), std::max(move->at, move->at + time_offset));
 		move->at += time_offset;
 	}
-	NotifyActionsChanged(true);
+	NotifyActionsChanged(true, changed.fromMs, changed.toMs);
 }
 
 void Funscript::moveActionsPosition(std::vector<FunscriptAction*> moving, int32_t pos_offset)
 {
 	ClearSelection();
+	ChangedInterval changed;
 	for (auto move : moving) {
+		changed.Extend(move->at, move->at);
 		move->pos += pos_offset;
 		move->pos = Util::Clamp<int16_t>(move->pos, 0, 100);
 	}
-	NotifyActionsChanged(true);
+	NotifyActionsChanged(true, changed.fromMs, changed.toMs);
 }
 
 void Funscript::MoveSelectionTime(int32_t time_offset, float frameTimeMs) noexcept
@@ -692,11 +724,13 @@ void Funscript::MoveSelectionTime(int32_t time_offset, float frameTimeMs) noexce
 	}
 
 	ClearSelection();
+	ChangedInterval changed;
 	for (auto move : moving) {
+		changed.Extend(std::min(move->at, move->at + time_offset), std::max(move->at, move->at + time_offset));
 		move->at += time_offset;
 		data.selection.emplace_back(*move);
 	}
-	NotifyActionsChanged(true);
+	NotifyActionsChanged(true, changed.fromMs, changed.toMs);
 }
 
 void Funscript::MoveSelectionPosition(int32_t pos_offset) noexcept
@@ -720,12 +754,14 @@ void Funscript::MoveSelectionPosition(int32_t pos_offset) noexcept
 	}
 
 	ClearSelection();
+	ChangedInterval changed;
 	for (auto move : moving) {
+		changed.Extend(move->at, move->at);
 		move->pos += pos_offset;
 		move->pos = Util::Clamp<int16_t>(move->pos, 0, 100);
 		data.selection.emplace_back(*move);
 	}
-	NotifyActionsChanged(true);
+	NotifyActionsChanged(true, changed.fromMs, changed.toMs);
 }
 
 void Funscript::SetSelection(const std::vector<FunscriptAction>& action_to_select, bool unsafe) noexcept
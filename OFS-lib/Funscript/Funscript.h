@@ -10,11 +10,14 @@
 #include <memory>
 #include <chrono>
 #include <set>
+#include <limits>
+#include <algorithm>
 
 #include "OFS_Util.h"
 #include "SDL_mutex.h"
 
 #include "FunscriptSpline.h"
+#include "FunscriptLOD.h"
 
 class FunscriptUndoSystem;
 
@@ -67,6 +70,18 @@ public:
 		bool writeToFunscript(const std::string& path) noexcept;
 	} metadata;
 
+	// time range in which actions were changed
+	struct ChangedInterval {
+		int32_t fromMs = std::numeric_limits<int32_t>::max();
+		int32_t toMs = std::numeric_limits<int32_t>::min();
+
+		inline void Extend(int32_t from, int32_t to) noexcept {
+			fromMs = std::min(fromMs, from);
+			toMs = std::max(toMs, to);
+		}
+		inline bool Empty() const noexcept { return fromMs > toMs; }
+	};
+
 	std::shared_ptr<void> userdata = nullptr;
 private:
 	nlohmann::json Json;
@@ -78,6 +93,11 @@ private:
 	bool selectionChanged = false;
 	SDL_mutex* saveMutex = nullptr;
 
+	// accumulates until the next update
+	ChangedInterval pendingChange;
+	// range of the last FunscriptActionsChangedEvent
+	ChangedInterval lastChange;
+
 	void setBaseScript(nlohmann::json& base);
 	void setScriptTemplate() noexcept;
 	void checkForInvalidatedActions() noexcept;
@@ -102,7 +122,7 @@ private:
 			return newAction.at < action.at;
 			});
 		actions.insert(it, newAction);
-		NotifyActionsChanged(true);
+		NotifyActionsChanged(true, newAction.at, newAction.at);
 	}
 
 	void NotifySelectionChanged() noexcept;
@@ -119,20 +139,44 @@ private:
 	void startSaveThread(const std::string& path, nlohmann::json&& json) noexcept;
 	
 	bool SplineNeedsUpdate = true;
+	bool LODNeedsUpdate = true;
+
+	// unique across all scripts so caches keyed by script can't mix them up
+	static uint32_t ActionsVersionCounter;
+	uint32_t actionsVersion = 0;
+	uint32_t selectionVersion = 0;
 public:
 	Funscript();
 	~Funscript();
 
+	// without a time range the whole script is considered changed
 	inline void NotifyActionsChanged(bool isEdit) noexcept {
+		NotifyActionsChanged(isEdit, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max());
+	}
+
+	inline void NotifyActionsChanged(bool isEdit, int32_t fromMs, int32_t toMs) noexcept {
 		funscriptChanged = true;
 		if (isEdit && !unsavedEdits) {
 			unsavedEdits = true;
 			editTime = std::chrono::system_clock::now();
 		}
+		pendingChange.Extend(fromMs, toMs);
 		SplineNeedsUpdate = true;
+		LODNeedsUpdate = true;
+		actionsVersion = ++ActionsVersionCounter;
+		selectionVersion = actionsVersion;
 	}
 
+	// changes every time the actions change
+	inline uint32_t ActionsVersion() const noexcept { return actionsVersion; }
+	// changes every time the actions or the selection change
+	inline uint32_t SelectionVersion() const noexcept { return selectionVersion; }
+
+	// the time range which changed when the last FunscriptActionsChangedEvent was fired
+	inline const ChangedInterval& LastChange() const noexcept { return lastChange; }
+
 	FunscriptSpline ScriptSpline;
+	FunscriptLOD ScriptLOD;
 	std::unique_ptr<FunscriptUndoSystem> undoSystem;
 	std::string current_path;
 	bool Enabled = true;
@@ -143,7 +187,7 @@ public:
 	template<class UserType>
 	inline void AllocUser() noexcept;
 
-	inline void rollback(const FunscriptData& data) noexcept { this->data = data; NotifyActionsChanged(true); }
+	void rollback(const FunscriptData& data) noexcept;
 
 	void update() noexcept;
 
@@ -173,6 +217,42 @@ public:
 	inline const FunscriptAction* GetClosestAction(int32_t time_ms) noexcept { return getActionAtTime(data.Actions, time_ms, std::numeric_limits<uint32_t>::max()); }
 
 	float GetPositionAtTime(int32_t time_ms) noexcept;
+
+	// index of the first action at or after timeMs in sorted actions
+	// searches outwards from hint. with last frame's result as hint this is usually O(1)
+	inline static int32_t LowerBound(const std::vector<FunscriptAction>& actions, float timeMs, int32_t hint = 0) noexcept
+	{
+		const int32_t size = actions.size();
+		hint = Util::Clamp<int32_t>(hint, 0, size);
+		int32_t lo, hi;
+		if (hint < size && actions[hint].at < timeMs) {
+			// gallop forward
+			int32_t step = 1;
+			int32_t probe = hint + step;
+			lo = hint + 1;
+			while (probe < size && actions[probe].at < timeMs) {
+				lo = probe + 1;
+				step *= 2;
+				probe = hint + step;
+			}
+			hi = std::min(probe, size);
+		}
+		else {
+			// gallop backward
+			int32_t step = 1;
+			int32_t probe = hint - step;
+			hi = hint;
+			while (probe >= 0 && actions[probe].at >= timeMs) {
+				hi = probe;
+				step *= 2;
+				probe = hint - step;
+			}
+			lo = std::max(probe + 1, 0);
+		}
+		auto it = std::lower_bound(actions.begin() + lo, actions.begin() + hi, timeMs,
+			[](auto& action, float timeMs) { return action.at < timeMs; });
+		return std::distance(actions.begin(), it);
+	}
 	
 	inline void AddAction(FunscriptAction newAction) noexcept { addAction(data.Actions, newAction); }
 	void AddActionSafe(FunscriptAction newAction) noexcept;
@@ -208,7 +288,7 @@ public:
 	void MoveSelectionPosition(int32_t pos_offset) noexcept;
 	inline bool HasSelection() const noexcept { return data.selection.size() > 0; }
 	inline int32_t SelectionSize() const noexcept { return data.selection.size(); }
-	inline void ClearSelection() noexcept { data.selection.clear(); }
+	inline void ClearSelection() noexcept { data.selection.clear(); selectionVersion = ++ActionsVersionCounter; }
 	inline const FunscriptAction* GetClosestActionSelection(int32_t time_ms) noexcept { return getActionAtTime(data.selection, time_ms, std::numeric_limits<int32_t>::max()); }
 	
 	void SetSelection(const std::vector<FunscriptAction>& action_to_select, bool unsafe) noexcept;
@@ -233,6 +313,15 @@ public:
 	{
 		return Util::Clamp<float>(Spline(timeMs) * 100.f, 0.f, 100.f);
 	}
+
+	inline const FunscriptLOD& LOD() noexcept
+	{
+		if (LODNeedsUpdate) {
+			ScriptLOD.Update(Actions());
+			LODNeedsUpdate = false;
+		}
+		return ScriptLOD;
+	}
 };
 
 
@@ -294,6 +383,8 @@ inline bool Funscript::open(const std::string& file, const std::string& usersett
 		}
 	}
 	data.Actions.assign(actionSet.begin(), actionSet.end());
+	actionsVersion = ++ActionsVersionCounter;
+	selectionVersion = actionsVersion;
 
 	loadMetadata();
 	AllocUser<UserSettings>();	
@@ -1,17 +1,44 @@
 #include "FunscriptHeatmap.h"
 #include "OFS_Util.h"
 #include <array>
+#include <chrono>
+#include <random>
+#include <limits>
+#include <algorithm>
 
-void OFS::UpdateHeatmapGradient(float totalDurationMs, ImGradient& grad, const std::vector<FunscriptAction>& actions) noexcept
+// this comes fairly close to what ScriptPlayer's heatmap looks like
+constexpr float KernelSizeMs = 2500.f;
+constexpr float MaxActionsInKernel = 24.5f / (5.f / (KernelSizeMs / 1000.f));
+constexpr int32_t SegmentGapMs = 10000;
+// the moving average includes this many kernels before the current one
+constexpr uint32_t MaxSamples = 3;
+
+static const ImColor Black(IM_COL32(0, 0, 0, 255));
+
+inline static ImGradientMark HeatMark(float position, const ImColor& color) noexcept
 {
-    grad.clear();
-    grad.addMark(0.f, IM_COL32(0, 0, 0, 255));
-    grad.addMark(1.f, IM_COL32(0, 0, 0, 255));
+    position = Util::Clamp(position, 0.f, 1.f);
+    return ImGradientMark(color.Value.x, color.Value.y, color.Value.z, color.Value.w, position);
+}
 
-    if (actions.size() == 0) {
-        return;
+// replaces count elements at first with the range [begin, end)
+// only moves the tail of the vector if the size changes
+template<typename T, typename It>
+inline static void Splice(std::vector<T>& vec, size_t first, size_t count, It begin, It end) noexcept
+{
+    size_t withCount = std::distance(begin, end);
+    size_t overlap = std::min(count, withCount);
+    std::copy(begin, begin + overlap, vec.begin() + first);
+    if (withCount > count) {
+        vec.insert(vec.begin() + first + overlap, begin + overlap, end);
+    }
+    else if (count > withCount) {
+        vec.erase(vec.begin() + first + overlap, vec.begin() + first + count);
     }
+}
 
+OFS::FunscriptHeatmap::FunscriptHeatmap() noexcept
+{
     std::array<ImColor, 6> heatColor {
         IM_COL32(0x00, 0x00, 0x00, 0xFF),
         IM_COL32(0x1E, 0x90, 0xFF, 0xFF),
@@ -21,111 +48,398 @@ void OFS::UpdateHeatmapGradient(float totalDurationMs, ImGradient& grad, const s
         IM_COL32(0xFF, 0x00, 0x00, 0xFF),
     };
 
-
-    ImGradient HeatMap;
     float pos = 0.0f;
     for (auto& col : heatColor) {
-        HeatMap.addMark(pos, col);
+        heatColors.addMark(pos, col);
         pos += (1.f / (heatColor.size() - 1));
     }
-    HeatMap.refreshCache();
+    heatColors.refreshCache();
+}
 
-    auto getSegments = [](const std::vector<FunscriptAction>& actions, int32_t gapDurationMs) -> std::vector<std::vector<FunscriptAction>> {
-        int prev_direction = 0; // 0 neutral 0< up 0> down
-        std::vector<std::vector<FunscriptAction>> segments;
-        {
-            FunscriptAction previous(0, 0);
+bool OFS::FunscriptHeatmap::isSegmentStart(uint32_t idx) const noexcept
+{
+    auto& heatAction = filtered[idx];
+    return idx == 0 || heatAction.action.at - heatAction.previous.at >= SegmentGapMs;
+}
 
-            for (auto& action : actions)
-            {
-                if (previous.pos == action.pos) {
-                    continue;
-                }
+void OFS::FunscriptHeatmap::generateKernels(const Segment& segment, std::vector<Kernel>& output,
+    const Kernel* reuse, uint32_t reuseCount, int32_t reuseBackAt,
+    int32_t changedFromMs, int32_t changedToMs) const noexcept
+{
+    const auto segmentBegin = filtered.begin() + segment.firstAction;
+    const auto segmentEnd = segmentBegin + segment.actionCount;
+    const FunscriptAction front = segmentBegin->action;
+    const FunscriptAction back = (segmentEnd - 1)->action;
+
+    const float durationMs = back.at - front.at;
+    const float segmentEndMs = front.at + durationMs;
+    float kernelOffset = front.at;
+    uint32_t kernelIdx = 0;
+
+    // both only ever move forward since the kernel does
+    auto firstInKernel = segmentBegin;
+    auto lastInKernel = segmentBegin;
+    bool cursorsValid = true;
+    do {
+        Kernel kernel{ kernelOffset, 0.f };
+        // the old kernel sits on the same grid since the segment starts at the same time
+        // it can be reused if none of the changed actions fall into it
+        bool reusable = kernelIdx < reuseCount
+            && (kernelOffset < back.at) == (kernelOffset < reuseBackAt)
+            && (kernelOffset + KernelSizeMs < changedFromMs || kernelOffset > changedToMs);
 
-                // filter out actions which don't change direction
-                int direction = action.pos - previous.pos;
-                if (direction > 0 && prev_direction > 0) {
-                    previous = action;
-                    continue;
+        if (reusable) {
+            kernel.sample = reuse[kernelIdx].sample;
+            cursorsValid = false;
+        }
+        else {
+            int actionsInKernel = 0;
+            float kernelStart = kernelOffset;
+            float kernelEnd = kernelOffset + KernelSizeMs;
+
+            if (kernelOffset < back.at)
+            {
+                if (cursorsValid) {
+                    while (firstInKernel != segmentEnd && firstInKernel->action.at < kernelStart) { ++firstInKernel; }
+                    if (lastInKernel < firstInKernel) { lastInKernel = firstInKernel; }
+                    while (lastInKernel != segmentEnd && lastInKernel->action.at <= kernelEnd) { ++lastInKernel; }
                 }
-                else if (direction < 0 && prev_direction < 0) {
-                    previous = action;
-                    continue;
+                else {
+                    // skipped over reused kernels
+                    firstInKernel = std::lower_bound(firstInKernel, segmentEnd, kernelStart,
+                        [](const HeatAction& a, float time) { return a.action.at < time; });
+                    lastInKernel = std::upper_bound(firstInKernel, segmentEnd, kernelEnd,
+                        [](float time, const HeatAction& a) { return time < a.action.at; });
+                    cursorsValid = true;
                 }
+                actionsInKernel = lastInKernel - firstInKernel;
+            }
+            kernel.sample = Util::Clamp((float)actionsInKernel / MaxActionsInKernel, 0.0f, 1.0f);
+        }
 
-                prev_direction = direction;
+        output.emplace_back(kernel);
+        kernelOffset += KernelSizeMs;
+        kernelIdx++;
+    } while (kernelOffset < segmentEndMs);
+}
 
-                if (action.at - previous.at >= gapDurationMs) {
-                    segments.emplace_back();
-                }
-                if (segments.size() == 0) { segments.emplace_back(); }
-                segments.back().emplace_back(action);
+float OFS::FunscriptHeatmap::averagedSample(uint32_t kernelIdx) const noexcept
+{
+    // the moving average carries over from segment to segment
+    uint32_t sampleCount = std::min(kernelIdx + 1, MaxSamples + 1);
+    if (sampleCount <= 1) return kernels[kernelIdx].sample;
 
-                previous = action;
-            }
+    // summed from oldest to newest
+    float result = 0.f;
+    for (uint32_t i = kernelIdx + 1 - sampleCount; i <= kernelIdx; i++) {
+        result += kernels[i].sample;
+    }
+    result /= (float)sampleCount;
+    return result;
+}
 
-            return segments;
-        }
-    };
+void OFS::FunscriptHeatmap::emitSegmentMarks(const Segment& segment, std::vector<ImGradientMark>& marks) const noexcept
+{
+    marks.emplace_back(HeatMark((float)segment.frontAt / totalDurationMs, Black));
 
+    ImColor color(0.f, 0.f, 0.f, 1.f);
+    for (uint32_t i = segment.firstKernel, end = segment.firstKernel + segment.kernelCount; i < end; i++) {
+        heatColors.getColorAt(averagedSample(i), (float*)&color.Value);
+        marks.emplace_back(HeatMark((kernels[i].offset + KernelSizeMs) / totalDurationMs, color));
+    }
 
-    // this comes fairly close to what ScriptPlayer's heatmap looks like
-    constexpr float kernel_size_ms = 2500.f;
-    constexpr float max_actions_in_kernel = 24.5f / (5.f / (kernel_size_ms / 1000.f));
+    auto& lastKernel = kernels[segment.firstKernel + segment.kernelCount - 1];
+    marks.emplace_back(HeatMark(((lastKernel.offset + KernelSizeMs) + 1.f) / totalDurationMs, Black));
+}
 
+void OFS::FunscriptHeatmap::recolorKernels(ImGradient& grad, uint32_t segmentIdx, uint32_t firstKernel, uint32_t lastKernel) const noexcept
+{
+    // every segment has a black mark before & after its kernels
+    // the very first mark is the one at 0
+    auto& marks = grad.getMarks();
+    lastKernel = std::min(lastKernel, (uint32_t)kernels.size() - 1);
     ImColor color(0.f, 0.f, 0.f, 1.f);
+    for (uint32_t i = firstKernel; i <= lastKernel; i++) {
+        while (segments[segmentIdx].firstKernel + segments[segmentIdx].kernelCount <= i) { segmentIdx++; }
+        heatColors.getColorAt(averagedSample(i), (float*)&color.Value);
+        auto& mark = marks[1 + 2 * segmentIdx + 1 + i];
+        mark.color[0] = color.Value.x;
+        mark.color[1] = color.Value.y;
+        mark.color[2] = color.Value.z;
+    }
+}
 
-    constexpr int32_t max_samples = 3;
-    std::vector<float> samples;
-    samples.reserve(max_samples);
-
-    auto segments = getSegments(actions, 10000);
-    for (auto& segment : segments) {
-        const float durationMs = segment.back().at - segment.front().at;
-        float kernel_offset = segment.front().at;
-        grad.addMark(kernel_offset / totalDurationMs, IM_COL32(0, 0, 0, 255));
-        do {
-            int actions_in_kernel = 0;
-            float kernel_start = kernel_offset;
-            float kernel_end = kernel_offset + kernel_size_ms;
-
-            if (kernel_offset < segment.back().at)
-            {
-                for (int i = 0; i < segment.size(); i++) {
-                    auto& action = segment[i];
-                    if (action.at >= kernel_start && action.at <= kernel_end)
-                        actions_in_kernel++;
-                    else if (action.at > kernel_end)
-                        break;
-                }
+void OFS::FunscriptHeatmap::Update(float totalDurationMs, ImGradient& grad, const std::vector<FunscriptAction>& actions) noexcept
+{
+    filtered.clear();
+    segments.clear();
+    kernels.clear();
+    source = &actions;
+    this->totalDurationMs = totalDurationMs;
+
+    // the marks are emitted in order so they don't need sorting
+    auto& marks = grad.getMarks();
+    marks.clear();
+    marks.emplace_back(HeatMark(0.f, Black));
+
+    if (actions.size() > 0 && totalDurationMs > 0.f) {
+        DirectionFilter filter;
+        HeatAction kept;
+        for (auto action : actions) {
+            if (filter.Visit(action, kept)) { filtered.emplace_back(kept); }
+        }
+
+        for (uint32_t i = 0; i < filtered.size(); i++) {
+            if (i + 1 == filtered.size() || isSegmentStart(i + 1)) {
+                uint32_t first = segments.empty() ? 0 : segments.back().firstAction + segments.back().actionCount;
+                segments.emplace_back(Segment{ first, i + 1 - first, 0, 0, filtered[first].action.at, filtered[i].action.at });
             }
-            kernel_offset += kernel_size_ms;
+        }
+
+        for (auto& segment : segments) {
+            segment.firstKernel = kernels.size();
+            generateKernels(segment, kernels, nullptr, 0, 0, 0, 0);
+            segment.kernelCount = kernels.size() - segment.firstKernel;
+        }
+
+        for (auto& segment : segments) {
+            emitSegmentMarks(segment, marks);
+        }
+    }
+
+    marks.emplace_back(HeatMark(1.f, Black));
+    grad.updateCache();
+}
+
+void OFS::FunscriptHeatmap::Update(float totalDurationMs, ImGradient& grad, const std::vector<FunscriptAction>& actions, int32_t fromMs, int32_t toMs) noexcept
+{
+    if (fromMs > toMs) return;
+
+    auto& marks = grad.getMarks();
+    if (source != &actions
+        || totalDurationMs != this->totalDurationMs
+        || segments.empty()
+        || fromMs == std::numeric_limits<int32_t>::min()
+        || toMs == std::numeric_limits<int32_t>::max()
+        || marks.size() != 2 + 2 * segments.size() + kernels.size()) {
+        Update(totalDurationMs, grad, actions);
+        return;
+    }
+
+    // restart filtering at the last kept action before the change
+    // its filter state only depends on what came before it
+    int64_t restartIdx = std::lower_bound(filtered.begin(), filtered.end(), fromMs,
+        [](const HeatAction& a, int32_t time) { return a.action.at < time; }) - filtered.begin() - 1;
+    while (restartIdx >= 0 && filtered[restartIdx].previous.at >= filtered[restartIdx].action.at) { restartIdx--; }
 
-            float actionsRelToMax = Util::Clamp((float)actions_in_kernel / max_actions_in_kernel, 0.0f, 1.0f);
-            if (samples.size() == max_samples + 1) {
-                samples.erase(samples.begin());
+    DirectionFilter filter;
+    size_t actionIdx = 0;
+    uint32_t oldFirst = 0;
+    if (restartIdx >= 0) {
+        auto& restart = filtered[restartIdx];
+        auto it = std::lower_bound(actions.begin(), actions.end(), restart.action.at,
+            [](FunscriptAction a, int32_t time) { return a.at < time; });
+        while (it != actions.end() && it->at == restart.action.at && *it != restart.action) { ++it; }
+        if (it == actions.end() || *it != restart.action) {
+            Update(totalDurationMs, grad, actions);
+            return;
+        }
+        filter.previous = restart.previous;
+        filter.prevDirection = restart.prevDirection;
+        actionIdx = it - actions.begin();
+        oldFirst = restartIdx;
+    }
+
+    // filter until the output lines up with what was filtered before
+    changedActions.clear();
+    uint32_t oldLast = oldFirst;
+    bool resynced = false;
+    HeatAction kept;
+    for (; actionIdx < actions.size(); actionIdx++) {
+        if (!filter.Visit(actions[actionIdx], kept)) continue;
+        if (kept.action.at > toMs) {
+            while (oldLast < filtered.size() && filtered[oldLast].action.at < kept.action.at) { oldLast++; }
+            if (oldLast < filtered.size() && filtered[oldLast] == kept) {
+                resynced = true;
+                break;
             }
-            samples.emplace_back(actionsRelToMax);
+        }
+        changedActions.emplace_back(kept);
+    }
+    if (!resynced) oldLast = filtered.size();
 
-            auto getAverage = [](std::vector<float>& samples) {
-                float result = 0.f;
-                for (auto&& sample : samples) {
-                    result += sample;
-                }
-                result /= (float)samples.size();
-                return result;
-            };
+    uint32_t prefix = 0;
+    while (prefix < changedActions.size() && oldFirst + prefix < oldLast
+        && changedActions[prefix] == filtered[oldFirst + prefix]) {
+        prefix++;
+    }
+    uint32_t suffix = 0;
+    while (suffix < changedActions.size() - prefix && oldLast - suffix > oldFirst + prefix
+        && changedActions[changedActions.size() - 1 - suffix] == filtered[oldLast - 1 - suffix]) {
+        suffix++;
+    }
+
+    // [o0, o1) gets replaced with newCount actions
+    const uint32_t o0 = oldFirst + prefix;
+    const uint32_t o1 = oldLast - suffix;
+    const uint32_t newCount = changedActions.size() - prefix - suffix;
+    if (o0 == o1 && newCount == 0) return;
+
+    int32_t changedFromMs = std::numeric_limits<int32_t>::max();
+    int32_t changedToMs = std::numeric_limits<int32_t>::min();
+    auto extendChanged = [&](const HeatAction& a) {
+        changedFromMs = std::min(changedFromMs, a.action.at);
+        changedToMs = std::max(changedToMs, a.action.at);
+    };
+    for (uint32_t i = o0; i < o1; i++) { extendChanged(filtered[i]); }
+    for (uint32_t i = prefix; i < prefix + newCount; i++) { extendChanged(changedActions[i]); }
+
+    // segments from the one before the change up to the one containing the first unchanged action
+    auto segmentOf = [&](uint32_t actionIdx) -> uint32_t {
+        return std::upper_bound(segments.begin(), segments.end(), actionIdx,
+            [](uint32_t idx, const Segment& s) { return idx < s.firstAction; }) - segments.begin() - 1;
+    };
+    const uint32_t sA = segmentOf(o0 > 0 ? o0 - 1 : 0);
+    const uint32_t sB = o1 < filtered.size() ? segmentOf(o1) : segments.size() - 1;
+    const int64_t actionDelta = (int64_t)newCount - (int64_t)(o1 - o0);
+    const uint32_t firstAction = segments[sA].firstAction;
+    const uint32_t endAction = segments[sB].firstAction + segments[sB].actionCount + actionDelta;
+
+    Splice(filtered, o0, o1 - o0, changedActions.begin() + prefix, changedActions.begin() + prefix + newCount);
+    if (filtered.empty()) {
+        Update(totalDurationMs, grad, actions);
+        return;
+    }
+
+    // only changed actions and the first unchanged one can start a new segment
+    changedSegments.clear();
+    uint32_t segmentFirst = firstAction;
+    auto closeSegment = [&](uint32_t end) {
+        changedSegments.emplace_back(Segment{ segmentFirst, end - segmentFirst, 0, 0,
+            filtered[segmentFirst].action.at, filtered[end - 1].action.at });
+        segmentFirst = end;
+    };
+    for (uint32_t i = std::max(o0, firstAction + 1), end = std::min(o0 + newCount + 1, endAction); i < end; i++) {
+        if (isSegmentStart(i)) { closeSegment(i); }
+    }
+    closeSegment(endAction);
 
-            if (samples.size() > 1) {
-                actionsRelToMax = getAverage(samples);
+    const uint32_t firstKernel = segments[sA].firstKernel;
+    const uint32_t oldKernelCount = segments[sB].firstKernel + segments[sB].kernelCount - firstKernel;
+    changedKernels.clear();
+    uint32_t oldSegment = sA;
+    for (auto& segment : changedSegments) {
+        segment.firstKernel = firstKernel + changedKernels.size();
+        while (oldSegment <= sB && segments[oldSegment].frontAt < segment.frontAt) { oldSegment++; }
+        if (oldSegment <= sB && segments[oldSegment].frontAt == segment.frontAt) {
+            auto& old = segments[oldSegment];
+            generateKernels(segment, changedKernels, &kernels[old.firstKernel], old.kernelCount, old.backAt, changedFromMs, changedToMs);
+        }
+        else {
+            generateKernels(segment, changedKernels, nullptr, 0, 0, 0, 0);
+        }
+        segment.kernelCount = firstKernel + changedKernels.size() - segment.firstKernel;
+    }
+
+    bool sameLayout = changedSegments.size() == sB - sA + 1;
+    for (uint32_t i = 0; sameLayout && i < changedSegments.size(); i++) {
+        sameLayout = changedSegments[i].frontAt == segments[sA + i].frontAt
+            && changedSegments[i].kernelCount == segments[sA + i].kernelCount;
+    }
+
+    if (sameLayout) {
+        // all marks stay where they are only colors change
+        int64_t firstChanged = -1;
+        int64_t lastChanged = -1;
+        for (uint32_t i = 0; i < changedKernels.size(); i++) {
+            if (kernels[firstKernel + i].sample != changedKernels[i].sample) {
+                if (firstChanged < 0) firstChanged = firstKernel + i;
+                lastChanged = firstKernel + i;
             }
+            kernels[firstKernel + i] = changedKernels[i];
+        }
+        std::copy(changedSegments.begin(), changedSegments.end(), segments.begin() + sA);
+        for (uint32_t i = sA + changedSegments.size(); i < segments.size(); i++) {
+            segments[i].firstAction += actionDelta;
+        }
+        if (firstChanged >= 0) {
+            recolorKernels(grad, sA, firstChanged, lastChanged + MaxSamples);
+        }
+    }
+    else {
+        const int64_t kernelDelta = (int64_t)changedKernels.size() - (int64_t)oldKernelCount;
+        const uint32_t firstMark = 1 + 2 * sA + firstKernel;
+        const uint32_t markCount = 2 * (sB - sA + 1) + oldKernelCount;
 
-            HeatMap.getColorAt(actionsRelToMax, (float*)&color.Value);
-            float markPos = kernel_offset / totalDurationMs;
-            grad.addMark(markPos, color);
+        Splice(kernels, firstKernel, oldKernelCount, changedKernels.begin(), changedKernels.end());
+        Splice(segments, sA, sB - sA + 1, changedSegments.begin(), changedSegments.end());
+        const uint32_t nextSegment = sA + changedSegments.size();
+        for (uint32_t i = nextSegment; i < segments.size(); i++) {
+            segments[i].firstAction += actionDelta;
+            segments[i].firstKernel += kernelDelta;
+        }
+
+        changedMarks.clear();
+        for (uint32_t i = sA; i < nextSegment; i++) {
+            emitSegmentMarks(segments[i], changedMarks);
+        }
+        Splice(marks, firstMark, markCount, changedMarks.begin(), changedMarks.end());
 
-        } while (kernel_offset < (segment.front().at + durationMs));
-        grad.addMark((kernel_offset + 1.f) / totalDurationMs, IM_COL32(0, 0, 0, 255));
+        // the moving average carries over into the following segment
+        const uint32_t nextKernel = firstKernel + changedKernels.size();
+        if (nextKernel < kernels.size()) {
+            recolorKernels(grad, nextSegment, nextKernel, nextKernel + MaxSamples - 1);
+        }
+    }
+    grad.updateCache();
+}
+
+void OFS::FunscriptHeatmap::Benchmark() noexcept
+{
+    // 3 hours with a stroke roughly every 200-600ms and a few pauses
+    constexpr int32_t durationMs = 3 * 60 * 60 * 1000;
+    std::vector<FunscriptAction> actions;
+    std::mt19937 rng(1337);
+    std::uniform_int_distribution<int32_t> strokeMs(200, 600);
+    std::uniform_int_distribution<int32_t> pauseChance(0, 500);
+    bool up = true;
+    for (int32_t at = 0; at < durationMs; at += strokeMs(rng)) {
+        if (pauseChance(rng) == 0) { at += 15000; }
+        actions.emplace_back(at, up ? 90 : 10);
+        up = !up;
+    }
+
+    FunscriptHeatmap heatmap;
+    ImGradient grad;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    heatmap.Update(durationMs, grad, actions);
+    auto firstUpdate = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime);
+
+    // simulate edits by moving a single action
+    constexpr int32_t Iterations = 100;
+    std::uniform_int_distribution<size_t> actionIdx(0, actions.size() - 1);
+    startTime = std::chrono::high_resolution_clock::now();
+    for (int32_t i = 0; i < Iterations; i++) {
+        auto& action = actions[actionIdx(rng)];
+        action.pos = 100 - action.pos;
+        heatmap.Update(durationMs, grad, actions);
+    }
+    auto fullPerEdit = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime) / Iterations;
+
+    startTime = std::chrono::high_resolution_clock::now();
+    for (int32_t i = 0; i < Iterations; i++) {
+        auto& action = actions[actionIdx(rng)];
+        action.pos = 100 - action.pos;
+        heatmap.Update(durationMs, grad, actions, action.at, action.at);
     }
-    grad.refreshCache();
+    auto incrementalPerEdit = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime) / Iterations;
+
+    // the incremental result has to match a full update
+    FunscriptHeatmap reference;
+    ImGradient referenceGrad;
+    reference.Update(durationMs, referenceGrad, actions);
+    bool matches = grad.getMarks() == referenceGrad.getMarks();
+
+    LOGF_INFO("Heatmap benchmark: %zu actions, %zu marks. first update: %.3f ms, full per edit: %.3f ms, incremental per edit: %.4f ms, matches full update: %s",
+        actions.size(), grad.getMarks().size(), firstUpdate.count(), fullPerEdit.count(), incrementalPerEdit.count(), matches ? "yes" : "no");
 }
@@ -2,6 +2,94 @@
 #include "GradientBar.h"
 #include "FunscriptAction.h"
 
+#include <vector>
+#include <cstdint>
+
 namespace OFS {
-	void UpdateHeatmapGradient(float totalDurationMs , ImGradient& grad, const std::vector<FunscriptAction>& actions) noexcept;
-}
\ No newline at end of file
+	// computes the heatmap gradient of a script
+	// the buffers are reused so updating doesn't allocate after the first call
+	// after a full update edits only recompute the kernels around the changed time range
+	class FunscriptHeatmap
+	{
+		// an action which changes direction & the filter state before it
+		struct HeatAction {
+			FunscriptAction action;
+			FunscriptAction previous;
+			int32_t prevDirection;
+
+			inline bool operator==(const HeatAction& b) const noexcept {
+				return action == b.action && previous == b.previous && prevDirection == b.prevDirection;
+			}
+		};
+
+		// filters out actions which don't change direction
+		struct DirectionFilter {
+			FunscriptAction previous = FunscriptAction(0, 0);
+			int32_t prevDirection = 0; // 0 neutral 0< up 0> down
+
+			inline bool Visit(FunscriptAction action, HeatAction& kept) noexcept {
+				if (previous.pos == action.pos) {
+					return false;
+				}
+
+				int32_t direction = action.pos - previous.pos;
+				if ((direction > 0 && prevDirection > 0) || (direction < 0 && prevDirection < 0)) {
+					previous = action;
+					return false;
+				}
+
+				kept = HeatAction{ action, previous, prevDirection };
+				prevDirection = direction;
+				previous = action;
+				return true;
+			}
+		};
+
+		struct Segment {
+			uint32_t firstAction;
+			uint32_t actionCount;
+			uint32_t firstKernel;
+			uint32_t kernelCount;
+			int32_t frontAt;
+			int32_t backAt;
+		};
+
+		struct Kernel {
+			float offset;
+			// not yet averaged
+			float sample;
+		};
+
+		ImGradient heatColors;
+		std::vector<HeatAction> filtered;
+		std::vector<Segment> segments;
+		std::vector<Kernel> kernels;
+
+		// scratch buffers for incremental updates
+		std::vector<HeatAction> changedActions;
+		std::vector<Segment> changedSegments;
+		std::vector<Kernel> changedKernels;
+		std::vector<ImGradientMark> changedMarks;
+
+		// what the current state was computed from
+		const std::vector<FunscriptAction>* source = nullptr;
+		float totalDurationMs = 0.f;
+
+		bool isSegmentStart(uint32_t idx) const noexcept;
+		void generateKernels(const Segment& segment, std::vector<Kernel>& output,
+			const Kernel* reuse, uint32_t reuseCount, int32_t reuseBackAt,
+			int32_t changedFromMs, int32_t changedToMs) const noexcept;
+		float averagedSample(uint32_t kernelIdx) const noexcept;
+		void emitSegmentMarks(const Segment& segment, std::vector<ImGradientMark>& marks) const noexcept;
+		void recolorKernels(ImGradient& grad, uint32_t segmentIdx, uint32_t firstKernel, uint32_t lastKernel) const noexcept;
+	public:
+		FunscriptHeatmap() noexcept;
+
+		void Update(float totalDurationMs, ImGradient& grad, const std::vector<FunscriptAction>& actions) noexcept;
+		// actions only changed within [fromMs, toMs] since the last update
+		void Update(float totalDurationMs, ImGradient& grad, const std::vector<FunscriptAction>& actions, int32_t fromMs, int32_t toMs) noexcept;
+
+		// logs the cost of updating the heatmap of a generated 3 hour script
+		static void Benchmark() noexcept;
+	};
+}
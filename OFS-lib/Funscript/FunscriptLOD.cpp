@@ -0,0 +1,56 @@
+#include "FunscriptLOD.h"
+
+#include <cstdlib>
+
+void FunscriptLOD::Update(const std::vector<FunscriptAction>& actions) noexcept
+{
+	levelCount = 0;
+	if (actions.empty()) return;
+
+	// the buffers are kept around so edits don't allocate
+	auto level = [this](int32_t idx) -> std::vector<Bucket>& {
+		if (idx == levels.size()) { levels.emplace_back(); }
+		return levels[idx];
+	};
+
+	// the size only depends on the span of the script not on where it ends
+	originMs = actions.front().at;
+	const int64_t spanMs = (int64_t)actions.back().at - originMs;
+	baseBucketMs = BaseBucketMs;
+	while (spanMs / baseBucketMs >= MaxBaseBuckets) { baseBucketMs *= 2; }
+
+	auto& base = level(0);
+	base.assign(spanMs / baseBucketMs + 1, Bucket());
+	const FunscriptAction* prev = nullptr;
+	for (auto& action : actions) {
+		auto& bucket = base[((int64_t)action.at - originMs) / baseBucketMs];
+		if (bucket.Empty()) { bucket.first = action.pos; }
+		bucket.min = std::min(bucket.min, action.pos);
+		bucket.max = std::max(bucket.max, action.pos);
+		bucket.last = action.pos;
+		if (prev != nullptr) { bucket.travel += std::abs(action.pos - prev->pos); }
+		prev = &action;
+	}
+	levelCount = 1;
+
+	while (levels[levelCount - 1].size() > 1) {
+		// level() may append so finer has to be looked up afterwards
+		auto& coarser = level(levelCount);
+		auto& finer = levels[levelCount - 1];
+		coarser.resize((finer.size() + 1) / 2);
+		for (size_t i = 0; i < coarser.size(); i++) {
+			coarser[i] = finer[2 * i];
+			if (2 * i + 1 < finer.size()) { coarser[i].Merge(finer[2 * i + 1]); }
+		}
+		levelCount++;
+	}
+}
+
+int32_t FunscriptLOD::LevelFor(float maxBucketMs) const noexcept
+{
+	int32_t result = -1;
+	for (int32_t i = 0; i < levelCount && BucketMs(i) <= maxBucketMs; i++) {
+		result = i;
+	}
+	return result;
+}
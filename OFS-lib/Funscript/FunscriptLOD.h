@@ -0,0 +1,57 @@
+#pragma once
+
+#include "FunscriptAction.h"
+
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+
+// min/max envelopes of the actions at power-of-two time buckets
+// used to draw zoomed out timelines with one column per pixel
+class FunscriptLOD
+{
+public:
+	// 60fps scripts can't exceed two actions per bucket at this width
+	static constexpr int32_t BaseBucketMs = 32;
+	// long scripts get wider base buckets instead of more of them
+	static constexpr int32_t MaxBaseBuckets = 1 << 18;
+
+	struct Bucket {
+		int16_t min = std::numeric_limits<int16_t>::max();
+		int16_t max = std::numeric_limits<int16_t>::min();
+		int16_t first = 0;
+		int16_t last = 0;
+		// sum of the position changes ending in this bucket
+		int32_t travel = 0;
+
+		inline bool Empty() const noexcept { return min > max; }
+
+		inline void Merge(const Bucket& b) noexcept {
+			if (b.Empty()) return;
+			if (Empty()) { *this = b; return; }
+			min = std::min(min, b.min);
+			max = std::max(max, b.max);
+			last = b.last;
+			travel += b.travel;
+		}
+	};
+private:
+	// levels[0] has buckets of baseBucketMs every further level doubles the width
+	// the buckets start at originMs which is the first action
+	std::vector<std::vector<Bucket>> levels;
+	int32_t levelCount = 0;
+	int32_t originMs = 0;
+	int32_t baseBucketMs = BaseBucketMs;
+public:
+	void Update(const std::vector<FunscriptAction>& actions) noexcept;
+
+	// coarsest level with buckets no wider than maxBucketMs
+	// -1 if even the finest level is too coarse
+	int32_t LevelFor(float maxBucketMs) const noexcept;
+
+	inline int32_t LevelCount() const noexcept { return levelCount; }
+	inline int64_t BucketMs(int32_t level) const noexcept { return (int64_t)baseBucketMs << level; }
+	inline int32_t OriginMs() const noexcept { return originMs; }
+	inline const std::vector<Bucket>& Level(int32_t level) const noexcept { return levels[level]; }
+};
@@ -4,6 +4,8 @@
 
 #include "SDL.h"
 
+#include <algorithm>
+
 std::array<int64_t, SDL_CONTROLLER_BUTTON_MAX> ButtonsHeldDown = {-1};
 std::array<ControllerInput, 4> ControllerInput::Controllers;
 int32_t ControllerInput::activeControllers = 0;
@@ -98,6 +100,11 @@ void ControllerInput::setup(EventSystem& events)
 	events.Subscribe(SDL_CONTROLLERBUTTONUP, EVENT_SYSTEM_BIND(this, &ControllerInput::ControllerButtonUp));
 }
 
+bool ControllerInput::AnyButtonHeld() noexcept
+{
+	return std::any_of(ButtonsHeldDown.begin(), ButtonsHeldDown.end(), [](int64_t button) { return button > 0; });
+}
+
 void ControllerInput::update(int32_t buttonRepeatIntervalMs) noexcept
 {
 	int buttonEnumVal = 0;
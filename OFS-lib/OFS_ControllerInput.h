@@ -42,4 +42,6 @@ public:
 	inline const char* GetName() const noexcept { return SDL_GameControllerName(gamepad); }
 	inline bool connected() const noexcept { return is_connected; }
 	static inline bool AnythingConnected() noexcept { return activeControllers > 0; }
+	// held buttons get repeated by update
+	static bool AnyButtonHeld() noexcept;
 };
\ No newline at end of file
@@ -0,0 +1,190 @@
+#include "OFS_FrameIndex.h"
+#include "OFS_Util.h"
+
+#include "reproc++/reproc.hpp"
+#include "reproc++/drain.hpp"
+
+#include <array>
+#include <cstdio>
+#include <cinttypes>
+#include <algorithm>
+
+bool OFS_FrameIndex::Generate(const std::string& ffmpegPath, const std::string& videoPath, OFS_FrameIndex& output) noexcept
+{
+	output.Clear();
+
+	// the framecrc muxer prints one line per packet without decoding anything
+	// "#tb 0: 1001/30000" followed by "stream, dts, pts, duration, size, crc"
+	std::array<const char*, 14> args =
+	{
+		ffmpegPath.c_str(),
+		"-v", "error",
+		"-i", videoPath.c_str(),
+		// capital V skips attached pictures like cover art
+		"-map", "0:V:0",
+		"-c", "copy",
+		"-f", "framecrc",
+		"-",
+		nullptr
+	};
+
+	reproc::options options;
+	options.redirect.out.type = reproc::redirect::pipe;
+	options.redirect.err.type = reproc::redirect::parent;
+
+	reproc::process ffmpeg;
+	std::error_code ec = ffmpeg.start(args.data(), options);
+	if (ec) {
+		LOGF_ERROR("OFS_FrameIndex::Generate: failed to start ffmpeg. %s", ec.message().c_str());
+		return false;
+	}
+
+	int64_t timebaseNum = 0;
+	int64_t timebaseDen = 0;
+	std::vector<int64_t> pts;
+	std::string line;
+	auto parseLine = [&]() {
+		int32_t stream;
+		int64_t dts, packetPts;
+		if (line.empty()) return;
+		if (line[0] == '#') {
+			std::sscanf(line.c_str(), "#tb %" SCNd32 ": %" SCNd64 "/%" SCNd64, &stream, &timebaseNum, &timebaseDen);
+		}
+		else if (std::sscanf(line.c_str(), "%" SCNd32 ", %" SCNd64 ", %" SCNd64, &stream, &dts, &packetPts) == 3
+			&& packetPts != INT64_MIN) {
+			pts.emplace_back(packetPts);
+		}
+	};
+	auto lineSink = [&](reproc::stream stream, const uint8_t* buffer, size_t size) -> std::error_code {
+		for (size_t i = 0; i < size; i++) {
+			if (buffer[i] == '\n') {
+				parseLine();
+				line.clear();
+			}
+			else if (buffer[i] != '\r') {
+				line.push_back(buffer[i]);
+			}
+		}
+		return {};
+	};
+	ec = reproc::drain(ffmpeg, lineSink, reproc::sink::null);
+	if (ec) {
+		LOGF_ERROR("OFS_FrameIndex::Generate: %s", ec.message().c_str());
+	}
+	parseLine();
+
+	int status = 0;
+	std::tie(status, ec) = ffmpeg.wait(reproc::infinite);
+	if (ec || status != 0 || pts.empty() || timebaseNum <= 0 || timebaseDen <= 0) {
+		LOGF_ERROR("OFS_FrameIndex::Generate: ffmpeg failed. status: %d %s", status, ec.message().c_str());
+		return false;
+	}
+
+	// packets are in decoding order
+	std::sort(pts.begin(), pts.end());
+	pts.erase(std::unique(pts.begin(), pts.end()), pts.end());
+	output.timestamps.reserve(pts.size());
+	for (auto p : pts) {
+		output.timestamps.emplace_back((double)p * timebaseNum / timebaseDen);
+	}
+	LOGF_INFO("Indexed %" PRId64 " frames of \"%s\"", output.FrameCount(), videoPath.c_str());
+	return true;
+}
+
+int64_t OFS_FrameIndex::FrameAt(double seconds) const noexcept
+{
+	if (timestamps.empty()) return 0;
+	auto it = std::upper_bound(timestamps.begin(), timestamps.end(), seconds + Epsilon);
+	return std::max<int64_t>(0, (it - timestamps.begin()) - 1);
+}
+
+double OFS_FrameIndex::FrameTime(int64_t frame) const noexcept
+{
+	if (timestamps.empty()) return 0.0;
+	frame = Util::Clamp<int64_t>(frame, 0, timestamps.size() - 1);
+	return timestamps[frame];
+}
+
+// ===== cache =====
+
+struct FrameIndexCacheHeader {
+	char magic[4];
+	uint32_t version;
+	uint64_t frameCount;
+	uint64_t pathHash;
+	uint64_t mediaSize;
+	int64_t mediaMtime;
+	uint64_t contentHash;
+};
+static_assert(sizeof(FrameIndexCacheHeader) == 48);
+constexpr char FrameIndexCacheMagic[4] = { 'O', 'F', 'S', 'F' };
+constexpr uint32_t FrameIndexCacheVersion = 1;
+
+bool OFS_FrameIndex::SaveCache(const OFS_MediaCacheKey& key) const noexcept
+{
+	if (timestamps.empty()) return false;
+	auto cachePath = Util::PathFromString(key.CachePath("frames", "ofsframes"));
+	if (!Util::CreateDirectories(cachePath.parent_path())) return false;
+
+	FrameIndexCacheHeader header = {};
+	std::copy(std::begin(FrameIndexCacheMagic), std::end(FrameIndexCacheMagic), header.magic);
+	header.version = FrameIndexCacheVersion;
+	header.frameCount = timestamps.size();
+	header.pathHash = key.pathHash;
+	header.mediaSize = key.mediaSize;
+	header.mediaMtime = key.mediaMtime;
+	header.contentHash = key.contentHash;
+
+	auto tmpPath = cachePath;
+	tmpPath.replace_extension(".tmp");
+	auto handle = SDL_RWFromFile(tmpPath.u8string().c_str(), "wb");
+	if (handle == nullptr) {
+		LOGF_ERROR("Failed to write frame index cache: %s", SDL_GetError());
+		return false;
+	}
+	bool succ = SDL_RWwrite(handle, &header, sizeof(header), 1) == 1
+		&& SDL_RWwrite(handle, timestamps.data(), sizeof(double), timestamps.size()) == timestamps.size();
+	SDL_RWclose(handle);
+
+	std::error_code ec;
+	if (succ) {
+		std::filesystem::rename(tmpPath, cachePath, ec);
+		if (ec) {
+			LOGF_ERROR("Failed to write frame index cache: %s", ec.message().c_str());
+			succ = false;
+		}
+	}
+	if (!succ) {
+		std::filesystem::remove(tmpPath, ec);
+	}
+	return succ;
+}
+
+bool OFS_FrameIndex::LoadCache(const OFS_MediaCacheKey& key) noexcept
+{
+	// more than a day of 240 fps
+	constexpr uint64_t MaxFrameCount = 24ULL * 60 * 60 * 240;
+	Clear();
+	auto handle = SDL_RWFromFile(key.CachePath("frames", "ofsframes").c_str(), "rb");
+	if (handle == nullptr) return false;
+
+	FrameIndexCacheHeader header;
+	bool valid = SDL_RWread(handle, &header, sizeof(header), 1) == 1
+		&& std::equal(std::begin(FrameIndexCacheMagic), std::end(FrameIndexCacheMagic), header.magic)
+		&& header.version == FrameIndexCacheVersion
+		&& header.pathHash == key.pathHash
+		&& header.mediaSize == key.mediaSize
+		&& header.mediaMtime == key.mediaMtime
+		&& header.contentHash == key.contentHash
+		&& header.frameCount > 0 && header.frameCount <= MaxFrameCount;
+	if (valid) {
+		timestamps.resize(header.frameCount);
+		valid = SDL_RWread(handle, timestamps.data(), sizeof(double), timestamps.size()) == timestamps.size()
+			&& std::is_sorted(timestamps.begin(), timestamps.end());
+	}
+	SDL_RWclose(handle);
+	if (!valid) {
+		Clear();
+	}
+	return valid;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cmath>
+
+#include "OFS_MediaCacheKey.h"
+
+// sorted presentation timestamps of every frame in a video
+// built by demuxing the video stream with ffmpeg & cached on disk per video
+// makes frame stepping & snapping exact for variable frame rate content
+class OFS_FrameIndex
+{
+	// seconds, relative to the start of the video like mpv's time-pos
+	std::vector<double> timestamps;
+public:
+	// absorbs rounding errors of positions which were derived from a timestamp
+	static constexpr double Epsilon = 0.000001;
+
+	static bool Generate(const std::string& ffmpegPath, const std::string& videoPath, OFS_FrameIndex& output) noexcept;
+
+	bool SaveCache(const OFS_MediaCacheKey& key) const noexcept;
+	bool LoadCache(const OFS_MediaCacheKey& key) noexcept;
+
+	inline void Clear() noexcept { timestamps.clear(); timestamps.shrink_to_fit(); }
+	inline bool Empty() const noexcept { return timestamps.empty(); }
+	inline int64_t FrameCount() const noexcept { return timestamps.size(); }
+
+	// index of the frame which is displayed at seconds
+	int64_t FrameAt(double seconds) const noexcept;
+	// presentation timestamp of frame, clamped to the valid range
+	double FrameTime(int64_t frame) const noexcept;
+
+	// start of the frame displayed at timeMs rounded up to a whole millisecond
+	// rounding up keeps the millisecond inside of the frame
+	inline int32_t SnapMs(double timeMs) const noexcept {
+		return FrameTimeMs(FrameAt(timeMs / 1000.0));
+	}
+	inline int32_t FrameTimeMs(int64_t frame) const noexcept {
+		return (int32_t)std::ceil(FrameTime(frame) * 1000.0 - Epsilon);
+	}
+};
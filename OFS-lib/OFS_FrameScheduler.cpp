@@ -0,0 +1,56 @@
+#include "OFS_FrameScheduler.h"
+
+#include "SDL_events.h"
+#include "SDL_timer.h"
+#include "imgui.h"
+
+#include <algorithm>
+#include <cmath>
+
+void OFS_FrameScheduler::EndFrame(bool animating, bool vsync, int32_t framerateLimit) noexcept
+{
+	auto frameEnd = Clock::now();
+	float frameMs = std::chrono::duration<float, std::milli>(frameEnd - frameStart).count();
+
+	idle = !animating && SDL_GetTicks() - lastActivityTicks > ActivityGraceMs;
+	if (idle) {
+		// doesn't remove the event from the queue
+		SDL_WaitEventTimeout(nullptr, IdleTimeoutMs);
+		idleFrameCount++;
+	}
+	else if (!vsync) {
+		const float maxFrameMs = 1000.f / framerateLimit;
+		if (frameMs < maxFrameMs) {
+			SDL_Delay(std::round(maxFrameMs - frameMs));
+		}
+	}
+
+	frameMsSum += frameMs;
+	frameMsMax = std::max(frameMsMax, frameMs);
+	frameCount++;
+
+	auto now = Clock::now();
+	float reportMs = std::chrono::duration<float, std::milli>(now - reportStart).count();
+	if (reportMs >= 1000.f) {
+		report.fps = frameCount / (reportMs / 1000.f);
+		report.avgFrameMs = frameMsSum / frameCount;
+		report.maxFrameMs = frameMsMax;
+		report.busyPercent = 100.f * (frameMsSum / reportMs);
+		report.idlePercent = 100.f * (idleFrameCount / (float)frameCount);
+
+		reportStart = now;
+		frameMsSum = 0.0;
+		frameMsMax = 0.f;
+		frameCount = 0;
+		idleFrameCount = 0;
+	}
+}
+
+void OFS_FrameScheduler::ShowReport() const noexcept
+{
+	ImGui::Text("Frame loop: %s", idle ? "idle" : "active");
+	ImGui::Text("FPS: %.1f", report.fps);
+	ImGui::Text("Frame time: %.2f ms (max %.2f ms)", report.avgFrameMs, report.maxFrameMs);
+	ImGui::Text("Busy: %.1f%%", report.busyPercent);
+	ImGui::Text("Idle frames: %.1f%%", report.idlePercent);
+}
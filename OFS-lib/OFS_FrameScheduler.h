@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <chrono>
+
+// paces the main loop
+// while something is animating frames run at the framerate limit
+// otherwise the loop sleeps until the next event arrives
+class OFS_FrameScheduler
+{
+public:
+	// upper bound for an idle sleep so that timers like the auto backup keep running
+	static constexpr uint32_t IdleTimeoutMs = 250;
+	// full rate is kept for a while after the last event so that imgui can settle hover states etc.
+	static constexpr uint32_t ActivityGraceMs = 500;
+
+	// averages over the last second
+	struct Report {
+		float fps = 0.f;
+		float avgFrameMs = 0.f;
+		float maxFrameMs = 0.f;
+		// percentage of wall time spent on frames instead of waiting
+		float busyPercent = 0.f;
+		// percentage of frames which ended in an idle sleep
+		float idlePercent = 0.f;
+	};
+private:
+	using Clock = std::chrono::high_resolution_clock;
+
+	Clock::time_point frameStart = Clock::now();
+	Clock::time_point reportStart = Clock::now();
+	uint32_t lastActivityTicks = 0;
+
+	// accumulated since reportStart
+	double frameMsSum = 0.0;
+	float frameMsMax = 0.f;
+	uint32_t frameCount = 0;
+	uint32_t idleFrameCount = 0;
+
+	Report report;
+	bool idle = false;
+public:
+	// events processed during this frame
+	inline void Activity(uint32_t ticks) noexcept { lastActivityTicks = ticks; }
+
+	inline void BeginFrame() noexcept { frameStart = Clock::now(); }
+	// waits until the next frame should start
+	// an idle frame sleeps until an event arrives or IdleTimeoutMs passed
+	void EndFrame(bool animating, bool vsync, int32_t framerateLimit) noexcept;
+
+	inline bool IsIdle() const noexcept { return idle; }
+	inline const Report& LastReport() const noexcept { return report; }
+	void ShowReport() const noexcept;
+};
@@ -0,0 +1,95 @@
+#include "OFS_MappedFile.h"
+#include "OFS_Util.h"
+
+#include <utility>
+
+#if WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+OFS_MappedFile& OFS_MappedFile::operator=(OFS_MappedFile&& other) noexcept
+{
+	if (this != &other) {
+		Close();
+		std::swap(mappedData, other.mappedData);
+		std::swap(mappedSize, other.mappedSize);
+#if WIN32
+		std::swap(fileHandle, other.fileHandle);
+		std::swap(mappingHandle, other.mappingHandle);
+#else
+		std::swap(fd, other.fd);
+#endif
+	}
+	return *this;
+}
+
+bool OFS_MappedFile::Open(const std::string& path) noexcept
+{
+	Close();
+#if WIN32
+	std::wstring wpath = Util::Utf8ToUtf16(path);
+	// share delete so that a new cache file can be renamed over the mapped one
+	HANDLE file = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) return false;
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+		CloseHandle(file);
+		return false;
+	}
+	HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping == NULL) {
+		CloseHandle(file);
+		return false;
+	}
+	void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (data == nullptr) {
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+	fileHandle = file;
+	mappingHandle = mapping;
+	mappedData = (const uint8_t*)data;
+	mappedSize = size.QuadPart;
+#else
+	int file = open(path.c_str(), O_RDONLY);
+	if (file < 0) return false;
+	struct stat st;
+	if (fstat(file, &st) != 0 || st.st_size == 0) {
+		close(file);
+		return false;
+	}
+	void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	if (data == MAP_FAILED) {
+		close(file);
+		return false;
+	}
+	fd = file;
+	mappedData = (const uint8_t*)data;
+	mappedSize = st.st_size;
+#endif
+	return true;
+}
+
+void OFS_MappedFile::Close() noexcept
+{
+#if WIN32
+	if (mappedData != nullptr) UnmapViewOfFile(mappedData);
+	if (mappingHandle != nullptr) CloseHandle(mappingHandle);
+	if (fileHandle != nullptr) CloseHandle(fileHandle);
+	mappingHandle = nullptr;
+	fileHandle = nullptr;
+#else
+	if (mappedData != nullptr) munmap((void*)mappedData, mappedSize);
+	if (fd >= 0) close(fd);
+	fd = -1;
+#endif
+	mappedData = nullptr;
+	mappedSize = 0;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// read-only memory mapping of a whole file
+class OFS_MappedFile
+{
+	const uint8_t* mappedData = nullptr;
+	size_t mappedSize = 0;
+#if WIN32
+	void* fileHandle = nullptr;
+	void* mappingHandle = nullptr;
+#else
+	int fd = -1;
+#endif
+public:
+	OFS_MappedFile() noexcept {}
+	~OFS_MappedFile() noexcept { Close(); }
+
+	OFS_MappedFile(const OFS_MappedFile&) = delete;
+	OFS_MappedFile& operator=(const OFS_MappedFile&) = delete;
+	OFS_MappedFile(OFS_MappedFile&& other) noexcept { *this = std::move(other); }
+	OFS_MappedFile& operator=(OFS_MappedFile&& other) noexcept;
+
+	bool Open(const std::string& path) noexcept;
+	void Close() noexcept;
+
+	inline bool IsOpen() const noexcept { return mappedData != nullptr; }
+	inline const uint8_t* Data() const noexcept { return mappedData; }
+	inline size_t Size() const noexcept { return mappedSize; }
+};
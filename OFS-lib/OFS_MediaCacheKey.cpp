@@ -0,0 +1,55 @@
+#include "OFS_MediaCacheKey.h"
+#include "OFS_Util.h"
+
+#include <algorithm>
+
+static uint64_t Fnv1a(const void* data, size_t size, uint64_t hash = 0xcbf29ce484222325ULL) noexcept
+{
+	const uint8_t* bytes = (const uint8_t*)data;
+	for (size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+
+bool OFS_MediaCacheKey::FromMedia(const std::string& mediaPath, OFS_MediaCacheKey& key) noexcept
+{
+	constexpr size_t HashedBytes = 64 * 1024;
+	std::error_code ec;
+	auto path = Util::PathFromString(mediaPath);
+	auto mtime = std::filesystem::last_write_time(path, ec);
+	if (ec) return false;
+
+	auto handle = SDL_RWFromFile(mediaPath.c_str(), "rb");
+	if (handle == nullptr) return false;
+	int64_t size = SDL_RWsize(handle);
+	if (size <= 0) {
+		SDL_RWclose(handle);
+		return false;
+	}
+
+	std::vector<uint8_t> buffer(HashedBytes);
+	uint64_t hash = Fnv1a(&size, sizeof(size));
+	size_t read = SDL_RWread(handle, buffer.data(), 1, buffer.size());
+	hash = Fnv1a(buffer.data(), read, hash);
+	if (size > HashedBytes) {
+		SDL_RWseek(handle, std::max<int64_t>(size - HashedBytes, HashedBytes), RW_SEEK_SET);
+		read = SDL_RWread(handle, buffer.data(), 1, buffer.size());
+		hash = Fnv1a(buffer.data(), read, hash);
+	}
+	SDL_RWclose(handle);
+
+	key.pathHash = Fnv1a(mediaPath.data(), mediaPath.size());
+	key.mediaSize = size;
+	key.mediaMtime = mtime.time_since_epoch().count();
+	key.contentHash = hash;
+	return true;
+}
+
+std::string OFS_MediaCacheKey::CachePath(const char* directory, const char* extension) const noexcept
+{
+	char name[128];
+	stbsp_snprintf(name, sizeof(name), "%s/%016llx.%s", directory, (unsigned long long)pathHash, extension);
+	return Util::Prefpath(name);
+}
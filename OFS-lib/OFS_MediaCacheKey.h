@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+// identifies the media file cached data was generated from
+struct OFS_MediaCacheKey {
+	uint64_t pathHash = 0;
+	uint64_t mediaSize = 0;
+	int64_t mediaMtime = 0;
+	// hash over the beginning & the end of the file
+	uint64_t contentHash = 0;
+
+	static bool FromMedia(const std::string& mediaPath, OFS_MediaCacheKey& key) noexcept;
+	// <prefpath>/<directory>/<pathHash>.<extension>
+	std::string CachePath(const char* directory, const char* extension) const noexcept;
+
+	inline bool operator==(const OFS_MediaCacheKey& other) const noexcept {
+		return pathHash == other.pathHash
+			&& mediaSize == other.mediaSize
+			&& mediaMtime == other.mediaMtime
+			&& contentHash == other.contentHash;
+	}
+};
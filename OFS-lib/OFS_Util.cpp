@@ -190,14 +190,7 @@ void Util::OpenFileDialog(const std::string& title, const std::string& path, Fil
 			}
 		}
 
-		auto eventData = new EventSystem::SingleShotEventData;
-		eventData->ctx = dialogResult;
-		eventData->handler = std::move(data->handler);
-
-		SDL_Event ev{ 0 };
-		ev.type = EventSystem::SingleShotEvent;
-		ev.user.data1 = eventData;
-		SDL_PushEvent(&ev);
+		EventSystem::SingleShot(std::move(data->handler), dialogResult);
 		delete data;
 		return 0;
 	};
@@ -247,14 +240,7 @@ void Util::SaveFileDialog(const std::string& title, const std::string& path, Fil
 		if (result != nullptr) {
 			saveDialogResult->files.emplace_back(result);
 		}
-		auto eventData = new EventSystem::SingleShotEventData;
-		eventData->ctx = saveDialogResult;
-		eventData->handler = std::move(data->handler);
-
-		SDL_Event ev{ 0 };
-		ev.type = EventSystem::SingleShotEvent;
-		ev.user.data1 = eventData;
-		SDL_PushEvent(&ev);
+		EventSystem::SingleShot(std::move(data->handler), saveDialogResult);
 		delete data;
 		return 0;
 	};
@@ -301,14 +287,7 @@ void Util::OpenDirectoryDialog(const std::string& title, const std::string& path
 			directoryDialogResult->files.emplace_back(result);
 		}
 	
-		auto eventData = new EventSystem::SingleShotEventData;
-		eventData->ctx = directoryDialogResult;
-		eventData->handler = std::move(data->handler);
-
-		SDL_Event ev{ 0 };
-		ev.type = EventSystem::SingleShotEvent;
-		ev.user.data1 = eventData;
-		SDL_PushEvent(&ev);
+		EventSystem::SingleShot(std::move(data->handler), directoryDialogResult);
 		delete data;
 		return 0;
 	};
@@ -389,10 +368,14 @@ void Util::ConcatPathSafe(std::filesystem::path& path, const std::string& elemen
 
 bool Util::SavePNG(const std::string& path, void* buffer, int32_t width, int32_t height, int32_t channels, bool flipVertical) noexcept
 {
-	stbi_flip_vertically_on_write(flipVertical);
+	// a negative stride writes the rows bottom-up
+	// stb's flip flag is global & would race with the encoders on other threads
+	const int32_t rowBytes = width * channels;
+	auto pixels = (const uint8_t*)buffer;
+	if (flipVertical) { pixels += (size_t)(height - 1) * rowBytes; }
 	bool success = stbi_write_png(path.c_str(),
 		width, height,
-		channels, buffer, 0
+		channels, pixels, flipVertical ? -rowBytes : rowBytes
 	);
 	return success;
 }
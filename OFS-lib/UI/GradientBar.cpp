@@ -36,27 +36,21 @@ void ImGradient::computeColorAt(float position, float* color) const noexcept
 {
 	position = ImClamp(position, 0.0f, 1.0f);
 
-	const ImGradientMark* lower = nullptr;
-	const ImGradientMark* upper = nullptr;
+	auto upperIt = std::lower_bound(m_marks.begin(), m_marks.end(), position,
+		[](const ImGradientMark& mark, float pos) { return mark.position < pos; });
+	colorAt(upperIt - m_marks.begin(), position, color);
+}
 
-	for (auto& m : m_marks)
+void ImGradient::colorAt(size_t upperIdx, float position, float* color) const noexcept
+{
+	// lower is the first mark of those closest before position
+	const ImGradientMark* upper = upperIdx < m_marks.size() ? &m_marks[upperIdx] : nullptr;
+	const ImGradientMark* lower = nullptr;
+	if (upperIdx > 0)
 	{
-		auto mark = &m;
-		if (mark->position < position)
-		{
-			if (!lower || lower->position < mark->position)
-			{
-				lower = mark;
-			}
-		}
-
-		if (mark->position >= position)
-		{
-			if (!upper || upper->position > mark->position)
-			{
-				upper = mark;
-			}
-		}
+		size_t lowerIdx = upperIdx - 1;
+		while (lowerIdx > 0 && m_marks[lowerIdx - 1].position == m_marks[lowerIdx].position) { lowerIdx--; }
+		lower = &m_marks[lowerIdx];
 	}
 
 	if (upper && !lower)
@@ -94,13 +88,44 @@ void ImGradient::computeColorAt(float position, float* color) const noexcept
 void ImGradient::refreshCache() noexcept
 {
 	std::sort(m_marks.begin(), m_marks.end(), [](auto& a, auto& b) { return a.position < b.position; });
-	
+	updateCache();
+}
+
+void ImGradient::updateCache() noexcept
+{
 	for (int i = 0; i < 256; ++i)
 	{
 		computeColorAt(i / 255.0f, &m_cachedValues[i * 3]);
 	}
 }
 
+void ImGradient::rasterize(uint32_t* pixels, int32_t width) const noexcept
+{
+	// walks the marks once instead of searching them for every pixel
+	size_t upperIdx = 0;
+	ImVec4 color(0.f, 0.f, 0.f, 1.f);
+	for (int32_t x = 0; x < width; x++)
+	{
+		float position = ImClamp((x + 0.5f) / width, 0.0f, 1.0f);
+		while (upperIdx < m_marks.size() && m_marks[upperIdx].position < position) { upperIdx++; }
+		colorAt(upperIdx, position, &color.x);
+		pixels[x] = ImGui::ColorConvertFloat4ToU32(color);
+	}
+}
+
+void ImGradient::DrawGradientBar(ImTextureID texture, const ImVec2& bar_pos, float maxWidth, float height) noexcept
+{
+	ImDrawList* draw_list = ImGui::GetWindowDrawList();
+	float barBottom = bar_pos.y + height;
+
+	draw_list->AddRectFilled(ImVec2(bar_pos.x - 2, bar_pos.y - 2),
+		ImVec2(bar_pos.x + maxWidth + 2, barBottom + 2),
+		IM_COL32(100, 100, 100, 255));
+	draw_list->AddImage(texture, bar_pos, ImVec2(bar_pos.x + maxWidth, barBottom));
+
+	ImGui::SetCursorScreenPos(ImVec2(bar_pos.x, bar_pos.y + height + 10.0f));
+}
+
 void ImGradient::DrawGradientBar(ImGradient* gradient, const ImVec2& bar_pos, float maxWidth, float height) noexcept
 {
 	ImVec4 colorA = { 1,1,1,1 };
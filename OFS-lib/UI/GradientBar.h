@@ -1,6 +1,8 @@
 #pragma once
 
 #include <vector>
+#include <cstdint>
+#include <cstddef>
 
 #include "imgui.h"
 
@@ -40,14 +42,27 @@ public:
     void getColorAt(float position, float* color) const noexcept;
     void addMark(float position, ImColor const color) noexcept;
     void removeMark(const ImGradientMark& mark) noexcept;
+    // sorts the marks & updates the cached colors
     void refreshCache() noexcept;
+    // same as refreshCache for marks which are already sorted
+    void updateCache() noexcept;
     void clear() noexcept { m_marks.clear(); }
     std::vector<ImGradientMark>& getMarks() noexcept { return m_marks; }
 
     static void DrawGradientBar(ImGradient* gradient,const ImVec2& bar_pos, float maxWidth, float height) noexcept;
+    // draws a gradient which was rasterized into a texture
+    static void DrawGradientBar(ImTextureID texture, const ImVec2& bar_pos, float maxWidth, float height) noexcept;
 
+    // one ImGui U32 color per pixel column sampled at the pixel centers
+    // expects the marks to be sorted
+    void rasterize(uint32_t* pixels, int32_t width) const noexcept;
+
+    // expects the marks to be sorted
     void computeColorAt(float position, float* color) const noexcept;
 private:
+    // upperIdx is the first mark at or after position
+    void colorAt(size_t upperIdx, float position, float* color) const noexcept;
+
     std::vector<ImGradientMark> m_marks;
     float m_cachedValues[256 * 3];
 };
@@ -30,6 +30,9 @@ static const std::array<const char*, SDL_CONTROLLER_BUTTON_MAX> gameButtonString
 };
 
 
+// the only modifiers that are part of a binding
+static constexpr uint16_t BindingModifiers = KMOD_SHIFT | KMOD_CTRL | KMOD_ALT;
+
 static const char* GetButtonString(int32_t button) {
     if (button >= 0 && button < SDL_CONTROLLER_BUTTON_MAX) {
         //return SDL_GameControllerGetStringForButton((SDL_GameControllerButton)button);
@@ -100,6 +103,7 @@ void KeybindingSystem::KeyPressed(SDL_Event& ev) noexcept
                 currentlyChanging->key.key_str = "";
             }
             currentlyChanging = nullptr;
+            indexDirty = true;
             return;
         }
         currentlyHeldKeys.str("");
@@ -132,22 +136,14 @@ void KeybindingSystem::KeyPressed(SDL_Event& ev) noexcept
         }
         
         // check duplicate
-        for (auto&& group : ActiveBindings.groups) {
-            for (auto&& binding : group.bindings) {
-                if (binding.key.key == key.keysym.sym && binding.key.modifiers == modstate) {
-                    if (binding.identifier == currentlyChanging->identifier) {
-                        // the binding is being set to the key it already has which is fine
-                        goto breaking_out_of_nested_loop_lol;
-                    }
-                    LOGF_INFO("Key already bound for \"%s\"", binding.description.c_str());
-                    currentlyHeldKeys.str("");
-                    return;
-                }
-            }
+        auto bound = findKeyBindings(key.keysym.sym, modstate);
+        // the binding being set to the key it already has is fine
+        if (bound != nullptr && bound->front()->identifier != currentlyChanging->identifier) {
+            LOGF_INFO("Key already bound for \"%s\"", bound->front()->description.c_str());
+            currentlyHeldKeys.str("");
+            return;
         }
 
-        breaking_out_of_nested_loop_lol:
-
         addKeyString(SDL_GetKeyName(key.keysym.sym));
         currentlyChanging->key.key = key.keysym.sym;
         currentlyChanging->key.key_str = currentlyHeldKeys.str();
@@ -156,6 +152,7 @@ void KeybindingSystem::KeyPressed(SDL_Event& ev) noexcept
 
         currentlyChanging->key.modifiers = modstate;
         currentlyChanging = nullptr;
+        indexDirty = true;
         return;
     }
     if (ShowWindow) return;
@@ -163,28 +160,14 @@ void KeybindingSystem::KeyPressed(SDL_Event& ev) noexcept
     // this prevents keybindings from being processed when typing into a textbox etc.
     if (ImGui::IsAnyItemActive()) return;
     // process bindings
-    for (auto& group : ActiveBindings.groups) {
-        for (auto& binding : group.bindings) {
-            if (key.repeat && binding.ignore_repeats) continue;
-
-            if (key.keysym.sym == binding.key.key) {
-                bool modifierMismatch = false;
-                for (auto possibleModifier : possibleModifiers) {
-                    if ((modstate & possibleModifier) != (binding.key.modifiers & possibleModifier)) {
-                        modifierMismatch = true;
-                        break;
-                    }
-                }
-                if (modifierMismatch) continue;
-            }
-            else {
-                continue;
-            }
+    auto bindings = findKeyBindings(key.keysym.sym, modstate);
+    if (bindings == nullptr) return;
+    for (auto binding : *bindings) {
+        if (key.repeat && binding->ignore_repeats) continue;
 
-            // execute binding
-            binding.action(0);
-            return;
-        }
+        // execute binding
+        binding->action(0);
+        return;
     }
 }
 
@@ -193,22 +176,20 @@ void KeybindingSystem::ProcessControllerBindings(SDL_Event& ev, bool repeat) noe
     auto& cbutton = ev.cbutton;
     bool navmodeActive = ImGui::GetIO().ConfigFlags & ImGuiConfigFlags_NavEnableGamepad;
     // process bindings
-    for (auto&& group : ActiveBindings.groups) {
-        for (auto& binding : group.bindings) {
-            if ((binding.ignore_repeats && repeat) || binding.controller.button < 0) { continue; }
-            if (binding.controller.button == cbutton.button) {
-                if (navmodeActive) {
-                    // navmode bindings get processed during navmode
-                    // everything else doesn't get processed during navmode
-                    if (binding.controller.navmode) {
-                        binding.action(0);
-                    }
-                }
-                else {
-                    binding.action(0);
-                }
+    auto bindings = findButtonBindings(cbutton.button);
+    if (bindings == nullptr) return;
+    for (auto binding : *bindings) {
+        if (binding->ignore_repeats && repeat) { continue; }
+        if (navmodeActive) {
+            // navmode bindings get processed during navmode
+            // everything else doesn't get processed during navmode
+            if (binding->controller.navmode) {
+                binding->action(0);
             }
         }
+        else {
+            binding->action(0);
+        }
     }
 }
 
@@ -225,21 +206,15 @@ void KeybindingSystem::ControllerButtonDown(SDL_Event& ev) noexcept
     if (currentlyChanging != nullptr) {
         auto& cbutton = ev.cbutton;
         // check duplicate
-        for (auto&& group : ActiveBindings.groups) {
-            for (auto&& binding : group.bindings) {
-                if (binding.controller.button == cbutton.button) {
-                    if (binding.identifier == currentlyChanging->identifier) {
-                        // the binding is being set to the key it already has which is fine
-                        goto breaking_out_of_nested_loop_lol;
-                    }
-                    LOGF_INFO("The button is already bound for \"%s\"", binding.description.c_str());
-                    return;
-                }
-            }
+        auto bound = findButtonBindings(cbutton.button);
+        // the binding being set to the button it already has is fine
+        if (bound != nullptr && bound->front()->identifier != currentlyChanging->identifier) {
+            LOGF_INFO("The button is already bound for \"%s\"", bound->front()->description.c_str());
+            return;
         }
-        breaking_out_of_nested_loop_lol:
         currentlyChanging->controller.button = cbutton.button;
         currentlyChanging = nullptr;
+        indexDirty = true;
         return;
     }
     if (ShowWindow) return;
@@ -248,6 +223,37 @@ void KeybindingSystem::ControllerButtonDown(SDL_Event& ev) noexcept
 
 
 
+void KeybindingSystem::rebuildIndex() noexcept
+{
+    keyIndex.clear();
+    for (auto& bindings : buttonIndex) { bindings.clear(); }
+    for (auto& group : ActiveBindings.groups) {
+        for (auto& binding : group.bindings) {
+            if (binding.key.key != SDLK_UNKNOWN) {
+                keyIndex[keyIndexKey(binding.key.key, binding.key.modifiers & BindingModifiers)].emplace_back(&binding);
+            }
+            if (binding.controller.button >= 0 && binding.controller.button < SDL_CONTROLLER_BUTTON_MAX) {
+                buttonIndex[binding.controller.button].emplace_back(&binding);
+            }
+        }
+    }
+    indexDirty = false;
+}
+
+const std::vector<Binding*>* KeybindingSystem::findKeyBindings(SDL_Keycode key, uint16_t modifiers) noexcept
+{
+    if (indexDirty) rebuildIndex();
+    auto it = keyIndex.find(keyIndexKey(key, modifiers & BindingModifiers));
+    return it != keyIndex.end() ? &it->second : nullptr;
+}
+
+const std::vector<Binding*>* KeybindingSystem::findButtonBindings(int32_t button) noexcept
+{
+    if (indexDirty) rebuildIndex();
+    if (button < 0 || button >= SDL_CONTROLLER_BUTTON_MAX || buttonIndex[button].empty()) return nullptr;
+    return &buttonIndex[button];
+}
+
 void KeybindingSystem::addKeyString(const char* name)
 {
     if (currentlyHeldKeys.tellp() == 0)
@@ -294,6 +300,7 @@ const std::string& KeybindingSystem::getBindingString(const char* binding_id) no
 
 void KeybindingSystem::setBindings(const Keybindings& bindings)
 {
+    indexDirty = true;
     // setBindings only does something if the bindings were previously registered
     for (auto& group : bindings.groups) {
         for (auto& keybind : group.bindings) {
@@ -323,6 +330,8 @@ void KeybindingSystem::setBindings(const Keybindings& bindings)
 
 void KeybindingSystem::registerBinding(const KeybindingGroup& group)
 {
+    // growing the groups moves the bindings
+    indexDirty = true;
     ActiveBindings.groups.emplace_back(std::move(group));
     for (auto& binding : ActiveBindings.groups.back().bindings) {
         binding.key.key_str = loadKeyString(binding.key.key, binding.key.modifiers);
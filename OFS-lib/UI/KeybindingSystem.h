@@ -9,6 +9,7 @@
 
 #include <string>
 #include <vector>
+#include <array>
 #include <functional>
 #include <sstream>
 #include <unordered_map>
@@ -126,6 +127,20 @@ class KeybindingSystem
 	void addKeyString(const char* name);
 	void addKeyString(char name);
 	Keybindings ActiveBindings;
+
+	// bindings in group order by key & modifiers and by controller button
+	// rebuilt before the next lookup whenever a binding changed
+	std::unordered_map<uint64_t, std::vector<Binding*>> keyIndex;
+	std::array<std::vector<Binding*>, SDL_CONTROLLER_BUTTON_MAX> buttonIndex;
+	bool indexDirty = true;
+
+	static inline uint64_t keyIndexKey(SDL_Keycode key, uint16_t modifiers) noexcept {
+		return ((uint64_t)(uint32_t)key << 16) | modifiers;
+	}
+	void rebuildIndex() noexcept;
+	const std::vector<Binding*>* findKeyBindings(SDL_Keycode key, uint16_t modifiers) noexcept;
+	const std::vector<Binding*>* findButtonBindings(int32_t button) noexcept;
+
 	std::string loadKeyString(SDL_Keycode key, int mod);
 	
 	void ProcessControllerBindings(SDL_Event& ev, bool repeat) noexcept;
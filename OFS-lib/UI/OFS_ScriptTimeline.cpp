@@ -8,6 +8,10 @@
 #include "stb_sprintf.h"
 
 #include <array>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <random>
 
 int32_t ScriptTimelineEvents::FfmpegAudioProcessingFinished = 0;
 int32_t ScriptTimelineEvents::ScriptpositionWindowDoubleClick = 0;
@@ -49,6 +53,7 @@ void ScriptTimeline::FfmpegAudioProcessingFinished(SDL_Event& ev) noexcept
 void ScriptTimeline::setup(UndoSystem* undoSystem)
 {
 	this->undoSystem = undoSystem;
+	renderer.SetSpeedGradient(&BaseOverlay::speedGradient);
 	EventSystem::ev().Subscribe(SDL_MOUSEBUTTONDOWN, EVENT_SYSTEM_BIND(this, &ScriptTimeline::mouse_pressed));
 	EventSystem::ev().Subscribe(SDL_MOUSEWHEEL, EVENT_SYSTEM_BIND(this, &ScriptTimeline::mouse_scroll));
 	EventSystem::ev().Subscribe(SDL_MOUSEMOTION, EVENT_SYSTEM_BIND(this, &ScriptTimeline::mouse_drag));
@@ -57,12 +62,40 @@ void ScriptTimeline::setup(UndoSystem* undoSystem)
 	EventSystem::ev().Subscribe(VideoEvents::MpvVideoLoaded, EVENT_SYSTEM_BIND(this, &ScriptTimeline::videoLoaded));
 }
 
+const FunscriptAction* ScriptTimeline::actionAtPoint(const ImVec2& point) noexcept
+{
+	if (!BaseOverlay::ShowActions) return nullptr;
+
+	// the hit test uses the actions even when the lane draws the LOD
+	// map the hit box back to time & only test the actions inside of it
+	const ImVec2 size(10, 10);
+	for (auto& lane : laneCanvases) {
+		auto script = lane.script.lock();
+		if (script == nullptr) continue;
+		if (point.y < lane.pos.y - size.y || point.y > lane.pos.y + lane.size.y + size.y) continue;
+
+		auto& actions = script->Actions();
+		const float msPerPixel = visibleSizeMs / lane.size.x;
+		const float timeMs = offset_ms + ((point.x - lane.pos.x) * msPerPixel);
+		for (int32_t i = Funscript::LowerBound(actions, timeMs - (size.x * msPerPixel));
+			i < actions.size() && actions[i].at <= timeMs + (size.x * msPerPixel); i++) {
+			auto vert = getPointForAction(lane.pos, lane.size, actions[i]);
+			ImRect rect(vert - size, vert + size);
+			if (rect.Contains(point)) {
+				return &actions[i];
+			}
+		}
+	}
+	return nullptr;
+}
+
 void ScriptTimeline::mouse_pressed(SDL_Event& ev) noexcept
 {
 	auto& button = ev.button;
 	auto mousePos = ImGui::GetMousePos();
 	auto modstate = SDL_GetModState();
-	FunscriptAction* clickedAction = nullptr;
+	FunscriptAction clicked;
+	const FunscriptAction* clickedAction = nullptr;
 
 	if (PositionsItemHovered) {
 		if (button.button == SDL_BUTTON_LEFT && button.clicks == 2) {
@@ -78,22 +111,16 @@ void ScriptTimeline::mouse_pressed(SDL_Event& ev) noexcept
 		}
 
 		// test if an action has been clicked
-		int index = 0;
-		for (auto& vert : overlay->ActionScreenCoordinates) {
-			const ImVec2 size(10, 10);
-			ImRect rect(vert - size, vert + size);
-			if (rect.Contains(mousePos)) {
-				clickedAction = &overlay->ActionPositionWindow[index];
-				static FunscriptAction clickedActionStatic;
-				clickedActionStatic = *clickedAction;
-				
-				SDL_Event ev;
-				ev.type = ScriptTimelineEvents::FunscriptActionClicked;
-				ev.user.data1 = &clickedActionStatic;
-				SDL_PushEvent(&ev);
-				break;
-			}
-			index++;
+		if (auto hit = actionAtPoint(mousePos)) {
+			clicked = *hit;
+			clickedAction = &clicked;
+			static FunscriptAction clickedActionStatic;
+			clickedActionStatic = *clickedAction;
+
+			SDL_Event ev;
+			ev.type = ScriptTimelineEvents::FunscriptActionClicked;
+			ev.user.data1 = &clickedActionStatic;
+			SDL_PushEvent(&ev);
 		}
 	}
 	if (undoSystem == nullptr) return;
@@ -212,7 +239,69 @@ void ScriptTimeline::mouse_scroll(SDL_Event& ev) noexcept
 
 void ScriptTimeline::videoLoaded(SDL_Event& ev) noexcept
 {
+	// don't keep showing the waveform of the previous video
+	waveform.Clear();
 	videoPath = (const char*)ev.user.data1;
+	if (videoPath == nullptr) return;
+
+	// restore the waveform from the cache if it exists
+	auto loadCachedWaveform = [](void* user) -> int {
+		auto task = (WaveformTask*)user;
+		OFS_Waveform::CacheKey key;
+		if (OFS_Waveform::CacheKey::FromMedia(task->videoPath, key) && task->waveform.LoadCache(key)) {
+			LOGF_INFO("Loaded cached waveform for \"%s\"", task->videoPath.c_str());
+			EventSystem::SingleShot([](void* ctx) {
+				auto task = (WaveformTask*)ctx;
+				task->timeline->applyWaveformTask(task);
+			}, task);
+		}
+		else {
+			delete task;
+		}
+		return 0;
+	};
+	auto task = new WaveformTask();
+	task->timeline = this;
+	task->videoPath = videoPath;
+	auto handle = SDL_CreateThread(loadCachedWaveform, "OFS_LoadWaveform", task);
+	SDL_DetachThread(handle);
+}
+
+void ScriptTimeline::applyWaveformTask(WaveformTask* task) noexcept
+{
+	// the video might have changed in the meantime
+	// a failed generation doesn't replace the current waveform
+	if (videoPath != nullptr && task->videoPath == videoPath && task->waveform.SampleCount() > 0) {
+		waveform = std::move(task->waveform);
+		ShowAudioWaveform = true;
+	}
+	delete task;
+}
+
+uint64_t ScriptTimeline::laneContentKey(const OverlayDrawingCtx& ctx) noexcept
+{
+	// everything the lane content depends on
+	// the playhead, selection box & recording get drawn on top every frame
+	OFS_TimelineLaneCache::ContentKey key;
+	key.Add(ctx.script->ActionsVersion());
+	key.Add(ctx.script->SelectionVersion());
+	key.Add(ctx.script->metadata.title);
+	key.Add(ctx.scriptIdx);
+	key.Add(ctx.drawnScriptCount);
+	key.Add(ctx.offset_ms);
+	key.Add(ctx.visibleSizeMs);
+	key.Add(ctx.totalDurationMs);
+	key.Add(frameTimeMs);
+	key.Add(BaseOverlay::ShowActions);
+	key.Add(BaseOverlay::SplineMode);
+	key.Add(ShowAudioWaveform);
+	key.Add(ScaleAudio);
+	key.Add(waveform.Samples(OFS_Waveform::Low));
+	key.Add(waveform.SampleCount());
+	key.Add(overlay.get());
+	key.Add(ImGui::GetFontSize());
+	overlay->AddContentKey(key);
+	return key.Value();
 }
 
 void ScriptTimeline::ShowScriptPositions(bool* open, float currentPositionMs, float durationMs, float frameTimeMs, const std::vector<std::shared_ptr<Funscript>>& scripts, Funscript* activeScript) noexcept
@@ -235,6 +324,8 @@ void ScriptTimeline::ShowScriptPositions(bool* open, float currentPositionMs, fl
 	ImGui::Begin(PositionsId, open, ImGuiWindowFlags_None);
 	auto draw_list = ImGui::GetWindowDrawList();
 	drawingCtx.draw_list = draw_list;
+	renderer.NewFrame();
+	drawingCtx.renderer = &renderer;
 	PositionsItemHovered = ImGui::IsWindowHovered();
 
 	drawingCtx.drawnScriptCount = 0;
@@ -273,6 +364,9 @@ void ScriptTimeline::ShowScriptPositions(bool* open, float currentPositionMs, fl
 
 
 	ImGui::SetCursorScreenPos(startCursor);
+	windowHints.resize(scripts.size());
+	laneCanvases.clear();
+	laneCache.Resize(scripts.size());
 	for(int i=0; i < scripts.size(); i++) {
 		auto& scriptPtr = scripts[i];
 		auto& script = *scriptPtr.get();
@@ -284,31 +378,51 @@ void ScriptTimeline::ShowScriptPositions(bool* open, float currentPositionMs, fl
 		const ImGuiID itemID = ImGui::GetID(script.metadata.title.c_str());
 		ImRect itemBB(drawingCtx.canvas_pos, drawingCtx.canvas_pos + drawingCtx.canvas_size);
 		ImGui::ItemAdd(itemBB, itemID);
-
-		draw_list->AddRectFilledMultiColor(drawingCtx.canvas_pos, ImVec2(drawingCtx.canvas_pos.x + drawingCtx.canvas_size.x, drawingCtx.canvas_pos.y + drawingCtx.canvas_size.y),
-			IM_COL32(0, 0, 50, 255), IM_COL32(0, 0, 50, 255),
-			IM_COL32(0, 0, 20, 255), IM_COL32(0, 0, 20, 255)
-		);
-
-		auto startIt = std::find_if(script.Actions().begin(), script.Actions().end(),
-		    [&](auto& act) { return act.at >= offset_ms; });
-		if (startIt != script.Actions().begin()) {
-		    startIt -= 1;
+		laneCanvases.emplace_back(LaneCanvas{ scriptPtr, drawingCtx.canvas_pos, drawingCtx.canvas_size });
+
+		// the window of the last frame is a good guess for this one
+		auto& hint = windowHints[i];
+		auto& actions = script.Actions();
+		int32_t startIdx = Funscript::LowerBound(actions, offset_ms, hint.fromIdx);
+		int32_t endIdx = Funscript::LowerBound(actions, offset_ms + visibleSizeMs, hint.toIdx);
+		hint.fromIdx = startIdx;
+		hint.toIdx = endIdx;
+		if (startIdx > 0) {
+		    startIdx -= 1;
 		}
-
-		auto endIt = std::find_if(startIt, script.Actions().end(),
-		    [&](auto& act) { return act.at >= offset_ms + visibleSizeMs; });
-		if (endIt != script.Actions().end()) {
-		    endIt += 1;
+		if (endIdx < actions.size()) {
+		    endIdx += 1;
 		}
-		drawingCtx.actionFromIdx = std::distance(script.Actions().begin(), startIt);
-		drawingCtx.actionToIdx = std::distance(script.Actions().begin(), endIt);
+		drawingCtx.actionFromIdx = startIdx;
+		drawingCtx.actionToIdx = endIdx;
 		drawingCtx.script = scriptPtr.get();
 
-		// draws mode specific things in the timeline
-		// by default it draws the frame and time dividers
-		// DrawAudioWaveform called in scripting mode to control the draw order. spaghetti
-		overlay->DrawScriptPositionContent(drawingCtx);
+		// the lane only gets recorded again when its content changed
+		ImDrawList* laneList = draw_list;
+		if (CacheLanes) {
+			laneList = laneCache.Begin(i, laneContentKey(drawingCtx), drawingCtx.canvas_pos, drawingCtx.canvas_size);
+			renderer.SetTarget(laneCache.Target(i));
+		}
+		if (laneList != nullptr) {
+			drawingCtx.draw_list = laneList;
+			laneList->AddRectFilledMultiColor(drawingCtx.canvas_pos, ImVec2(drawingCtx.canvas_pos.x + drawingCtx.canvas_size.x, drawingCtx.canvas_pos.y + drawingCtx.canvas_size.y),
+				IM_COL32(0, 0, 50, 255), IM_COL32(0, 0, 50, 255),
+				IM_COL32(0, 0, 20, 255), IM_COL32(0, 0, 20, 255)
+			);
+
+			// draws mode specific things in the timeline
+			// by default it draws the frame and time dividers
+			// DrawAudioWaveform called in scripting mode to control the draw order. spaghetti
+			overlay->DrawScriptPositionContent(drawingCtx);
+
+			// draw points on top of lines
+			renderer.FlushOverlay(laneList);
+			drawingCtx.draw_list = draw_list;
+		}
+		renderer.SetTarget(nullptr);
+		if (CacheLanes) {
+			laneCache.Composite(i, draw_list, drawingCtx.canvas_pos);
+		}
 
 		// border
 		constexpr float borderThicknes = 1.f;
@@ -345,8 +459,16 @@ void ScriptTimeline::ShowScriptPositions(bool* open, float currentPositionMs, fl
 				}
 			}
 		};
-		int32_t startIndex = Util::Clamp<int32_t>((offset_ms / frameTimeMs), 0, recording.size());
-		int32_t endIndex = Util::Clamp<int32_t>(((float)offset_ms + visibleSizeMs) / frameTimeMs, startIndex, recording.size());
+		// the recording buffer is indexed by frame
+		int32_t startIndex, endIndex;
+		if (FrameIndex != nullptr && !FrameIndex->Empty()) {
+			startIndex = Util::Clamp<int32_t>(FrameIndex->FrameAt(offset_ms / 1000.0), 0, recording.size());
+			endIndex = Util::Clamp<int32_t>(FrameIndex->FrameAt((offset_ms + visibleSizeMs) / 1000.0) + 1, startIndex, recording.size());
+		}
+		else {
+			startIndex = Util::Clamp<int32_t>((offset_ms / frameTimeMs), 0, recording.size());
+			endIndex = Util::Clamp<int32_t>(((float)offset_ms + visibleSizeMs) / frameTimeMs, startIndex, recording.size());
+		}
 
 		pathRawSection(draw_list, recording, startIndex, endIndex);
 		pathStroke(draw_list, IM_COL32(0, 255, 0, 180));
@@ -405,40 +527,52 @@ void ScriptTimeline::ShowScriptPositions(bool* open, float currentPositionMs, fl
 			if (ImGui::BeginMenu("Rendering")) {
 				ImGui::MenuItem("Show actions", 0, &BaseOverlay::ShowActions);
 				ImGui::MenuItem("Spline mode", 0, &BaseOverlay::SplineMode);
+				ImGui::MenuItem("Cache lanes", 0, &CacheLanes);
 				ImGui::EndMenu();
 			}
 
 			auto updateAudioWaveformThread = [](void* userData) -> int {
-				auto& ctx = *((ScriptTimeline*)userData);
-				std::error_code ec;
-				auto basePath = Util::Basepath();
-#if WIN32
-				auto ffmpegPath = basePath / "ffmpeg.exe";
-#else
-				auto ffmpegPath = std::filesystem::path("ffmpeg");
-#endif
-				auto outputPath = Util::Prefpath("tmp");
-				if (!Util::CreateDirectories(outputPath)) {
-					return 0;
+				auto task = (WaveformTask*)userData;
+				auto ffmpegPath = Util::FfmpegPath();
+				bool succ = OFS_Waveform::Generate(ffmpegPath.u8string(), task->videoPath, task->waveform);
+				if (!succ) {
+					LOGF_ERROR("Failed to process audio from video. (ffmpeg_path: \"%s\")", ffmpegPath.u8string().c_str());
 				}
-				outputPath = (std::filesystem::path(outputPath) / "audio.mp3").u8string();
-
-				bool succ = ctx.waveform.GenerateMP3(ffmpegPath.u8string(), std::string(ctx.videoPath), outputPath);
-				if (!succ) { LOGF_ERROR("Failed to output mp3 from video. (ffmpeg_path: \"%s\")", ffmpegPath.u8string().c_str()); return 0;	}
-				succ = ctx.waveform.LoadMP3(outputPath);
-				if (!succ) { LOGF_ERROR("Failed load mp3. (path: \"%s\")", outputPath.c_str());	return 0; }
-				EventSystem::PushEvent(ScriptTimelineEvents::FfmpegAudioProcessingFinished);
+				else {
+					OFS_Waveform::CacheKey key;
+					if (OFS_Waveform::CacheKey::FromMedia(task->videoPath, key)) {
+						task->waveform.SaveCache(key);
+					}
+				}
+				EventSystem::SingleShot([](void* ctx) {
+					auto task = (WaveformTask*)ctx;
+					auto timeline = task->timeline;
+					timeline->GeneratingWaveform = false;
+					bool loaded = task->waveform.SampleCount() > 0;
+					timeline->applyWaveformTask(task);
+					if (loaded) {
+						EventSystem::PushEvent(ScriptTimelineEvents::FfmpegAudioProcessingFinished);
+					}
+					else {
+						// keep showing the previous waveform
+						timeline->ShowAudioWaveform = timeline->waveform.SampleCount() > 0;
+					}
+				}, task);
 				return 0;
 			};
 			if (ImGui::BeginMenu("Audio waveform")) {
 				ImGui::DragFloat("Waveform scale", &ScaleAudio, 0.01f, 0.01f, 10.f, "%.3f", ImGuiSliderFlags_AlwaysClamp);
-				if (ImGui::MenuItem("Enable waveform", NULL, &ShowAudioWaveform, !waveform.BusyGenerating())) {}
-				if (ImGui::MenuItem(waveform.BusyGenerating() 
+				if (ImGui::MenuItem("Enable waveform", NULL, &ShowAudioWaveform, !GeneratingWaveform)) {}
+				if (ImGui::MenuItem(GeneratingWaveform
 					? "Processing audio..." 
-					: "Update waveform", NULL, false, !waveform.BusyGenerating() && videoPath != nullptr)) {
-					if (!waveform.BusyGenerating()) {
+					: "Update waveform", NULL, false, !GeneratingWaveform && videoPath != nullptr)) {
+					if (!GeneratingWaveform) {
 						ShowAudioWaveform = false; // gets switched true after processing
-						auto handle = SDL_CreateThread(updateAudioWaveformThread, "OFS_GenWaveform", this);
+						GeneratingWaveform = true;
+						auto task = new WaveformTask();
+						task->timeline = this;
+						task->videoPath = videoPath;
+						auto handle = SDL_CreateThread(updateAudioWaveformThread, "OFS_GenWaveform", task);
 						SDL_DetachThread(handle);
 					}
 				}
@@ -448,18 +582,6 @@ void ScriptTimeline::ShowScriptPositions(bool* open, float currentPositionMs, fl
 		}
 	}
 
-	// draw points on top of lines
-	for (auto&& p : overlay->ActionScreenCoordinates) {
-		draw_list->AddCircleFilled(p, 7.0, IM_COL32(0, 0, 0, 255), 8); // border
-		draw_list->AddCircleFilled(p, 5.0, IM_COL32(255, 0, 0, 255), 8);
-	}
-
-	// draw selected points
-	for (auto&& p : overlay->SelectedActionScreenCoordinates) {
-		constexpr auto selectedDots = IM_COL32(11, 252, 3, 255);
-		draw_list->AddCircleFilled(p, 5.0, selectedDots, 8);
-	}
-
 	ImGui::End();
 }
 
@@ -473,48 +595,87 @@ void ScriptTimeline::DrawAudioWaveform(const OverlayDrawingCtx& ctx) noexcept
 	auto& canvas_pos = ctx.canvas_pos;
 	auto& canvas_size = ctx.canvas_size;
 	const auto draw_list = ctx.draw_list;
-	if (ShowAudioWaveform) {
-		const float durationMs = ctx.totalDurationMs;
-		const float rel_start = offset_ms / durationMs;
-		const float rel_end = ((float)(offset_ms)+visibleSizeMs) / durationMs;
-
-		int32_t start_index = rel_start * (float)waveform.SampleCount();
-		int32_t end_index = rel_end * (float)waveform.SampleCount();
-		const int total_samples = end_index - start_index;
-		const int line_merge = 1 + (total_samples / 1500);
-		const int actual_total_samples = total_samples / line_merge;
-
-		const float line_width = ((1.f / ((float)actual_total_samples)) * canvas_size.x) + 0.75f;
-		start_index -= start_index % line_merge;
-		end_index -= end_index % line_merge;
-		end_index += line_merge;
-
-		auto renderWaveform = [&](std::vector<float> samples, uint32_t color, float cullBelow)
-		{
-			for (int i = start_index; i < end_index - (line_merge + line_merge); i += line_merge) {
-				const float total_pos_x = ((((float)i - start_index) / (float)total_samples)) * canvas_size.x;
-				float total_len;
-				if (i < 0 || (i + line_merge) >= samples.size()) {
-					total_len = 0.f;
-					continue;
-				}
-				else {
-					float sample = samples[i];
-					for (int x = 1; x < line_merge; x++) {
-						// find peak
-						sample = std::max(sample, samples[i + x]);
-					}
-					if (sample < cullBelow) { continue; }
-					total_len = canvas_size.y * sample * ScaleAudio;
-				}
+	if (ShowAudioWaveform && waveform.SampleCount() > 0) {
+		const double sampleCount = waveform.SampleCount();
+		const double samplesPerMs = sampleCount / ctx.totalDurationMs;
+		const double firstSample = offset_ms * samplesPerMs;
+		const double visibleSamples = visibleSizeMs * samplesPerMs;
+
+		// one line per pixel or one line per sample when zoomed in further
+		// the lod makes every line O(1) regardless of the zoom
+		const int32_t lineCount = std::max(1, (int32_t)std::min<double>(canvas_size.x, std::ceil(visibleSamples)));
+		const double samplesPerLine = visibleSamples / lineCount;
+		const float lineStep = canvas_size.x / lineCount;
+		const float line_width = std::max(1.f, lineStep);
+
+		for (int32_t line = 0; line < lineCount; line++) {
+			int64_t first = std::floor(firstSample + line * samplesPerLine);
+			int64_t last = std::floor(firstSample + (line + 1) * samplesPerLine);
+			if (first < 0 || first >= sampleCount) { continue; }
+			last = std::max(last, first + 1);
+			const float total_pos_x = (line * lineStep) + (lineStep / 2.f);
+
+			struct BandSample { float value; uint32_t color; };
+			std::array<BandSample, 3> bands{
+				BandSample{ waveform.Lod(OFS_Waveform::High).Range(first, last).max, HighRangeCol },
+				BandSample{ waveform.Lod(OFS_Waveform::Mid).Range(first, last).max, MidRangeCol },
+				BandSample{ waveform.Lod(OFS_Waveform::Low).Range(first, last).max, LowRangeCol }
+			};
+			// the bands are independent draw the largest first so that all of them stay visible
+			std::sort(bands.begin(), bands.end(), [](auto& a, auto& b) { return a.value > b.value; });
+			for (auto& band : bands) {
+				const float total_len = canvas_size.y * band.value * ScaleAudio;
 				draw_list->AddLine(
 					canvas_pos + ImVec2(total_pos_x, (canvas_size.y / 2.f) + (total_len / 2.f)),
 					canvas_pos + ImVec2(total_pos_x, (canvas_size.y / 2.f) - (total_len / 2.f)),
-					color, line_width);
+					band.color, line_width);
 			}
-		};
-		renderWaveform(waveform.SamplesHigh, HighRangeCol, waveform.MidMax);
-		renderWaveform(waveform.SamplesMid, MidRangeCol, waveform.LowMax);
-		renderWaveform(waveform.SamplesLow, LowRangeCol, 0.f);
+		}
 	}
-}
\ No newline at end of file
+}
+
+void ScriptTimeline::BenchmarkCulling() noexcept
+{
+	// 3 hours with an action roughly every 200-600ms
+	constexpr int32_t durationMs = 3 * 60 * 60 * 1000;
+	std::vector<FunscriptAction> actions;
+	std::mt19937 rng(1337);
+	std::uniform_int_distribution<int32_t> strokeMs(200, 600);
+	bool up = true;
+	for (int32_t at = 0; at < durationMs; at += strokeMs(rng)) {
+		actions.emplace_back(at, up ? 90 : 10);
+		up = !up;
+	}
+
+	// playback one hour in with a 5 second window
+	constexpr int32_t Frames = 10000;
+	constexpr float visibleMs = 5000.f;
+	constexpr float frameMs = 1000.f / 60.f;
+	constexpr float startMs = 60.f * 60.f * 1000.f;
+
+	int64_t linearSum = 0;
+	auto startTime = std::chrono::high_resolution_clock::now();
+	for (int32_t i = 0; i < Frames; i++) {
+		float offsetMs = startMs + i * frameMs;
+		auto startIt = std::find_if(actions.begin(), actions.end(),
+			[&](auto& act) { return act.at >= offsetMs; });
+		auto endIt = std::find_if(startIt, actions.end(),
+			[&](auto& act) { return act.at >= offsetMs + visibleMs; });
+		linearSum += std::distance(actions.begin(), startIt) + std::distance(actions.begin(), endIt);
+	}
+	auto linearPerFrame = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - startTime) / Frames;
+
+	int64_t hintedSum = 0;
+	WindowHint hint;
+	startTime = std::chrono::high_resolution_clock::now();
+	for (int32_t i = 0; i < Frames; i++) {
+		float offsetMs = startMs + i * frameMs;
+		hint.fromIdx = Funscript::LowerBound(actions, offsetMs, hint.fromIdx);
+		hint.toIdx = Funscript::LowerBound(actions, offsetMs + visibleMs, hint.toIdx);
+		hintedSum += hint.fromIdx + hint.toIdx;
+	}
+	auto hintedPerFrame = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - startTime) / Frames;
+
+	LOGF_INFO("Timeline culling benchmark: %zu actions. linear search: %.3f us/frame, hinted binary search: %.3f us/frame, results match: %s",
+		actions.size(), linearPerFrame.count(), hintedPerFrame.count(), linearSum == hintedSum ? "yes" : "no");
+}
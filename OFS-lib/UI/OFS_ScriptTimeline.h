@@ -16,6 +16,7 @@
 #include "SDL_events.h"
 
 #include "OFS_Waveform.h"
+#include "OFS_FrameIndex.h"
 
 
 class ScriptTimelineEvents {
@@ -58,6 +59,8 @@ public:
 	
 	const char* videoPath = nullptr;
 	float frameTimeMs = 16.66667;
+	// snaps to exact frame times when it's not empty
+	const OFS_FrameIndex* FrameIndex = nullptr;
 	Funscript* activeScript = nullptr;
 	UndoSystem* undoSystem = nullptr;
 private:
@@ -85,11 +88,19 @@ private:
 		float relative_y = localCoord.y / canvas_size.y;
 		float at_ms = offset_ms + (relative_x * visibleSizeMs);
 		// fix frame alignment
-		at_ms =  std::max<float>((int32_t)(at_ms / frameTime) * frameTime, 0.f);
+		if (FrameIndex != nullptr && !FrameIndex->Empty()) {
+			at_ms = FrameIndex->SnapMs(std::max(at_ms, 0.f));
+		}
+		else {
+			at_ms = std::max<float>((int32_t)(at_ms / frameTime) * frameTime, 0.f);
+		}
 		float pos = Util::Clamp<float>(100.f - (relative_y * 100.f), 0.f, 100.f);
 		return FunscriptAction(at_ms, pos);
 	}
 
+	// the action of any visible lane whose point contains point
+	const FunscriptAction* actionAtPoint(const ImVec2& point) noexcept;
+
 	void updateSelection(bool clear);
 	void FfmpegAudioProcessingFinished(SDL_Event& ev) noexcept;
 
@@ -97,8 +108,37 @@ private:
 	int32_t startSelectionMs = -1;
 	
 	bool ShowAudioWaveform = false;
+	bool GeneratingWaveform = false;
 	float ScaleAudio = 1.f;
 	OFS_Waveform waveform;
+	OFS_TimelineRenderer renderer;
+	OFS_TimelineLaneCache laneCache;
+	bool CacheLanes = true;
+	uint64_t laneContentKey(const OverlayDrawingCtx& ctx) noexcept;
+
+	// background work on the waveform of videoPath
+	// the result gets moved into waveform on the main thread
+	struct WaveformTask {
+		ScriptTimeline* timeline = nullptr;
+		std::string videoPath;
+		OFS_Waveform waveform;
+	};
+	void applyWaveformTask(WaveformTask* task) noexcept;
+
+	// visible action window of every script in the last frame
+	struct WindowHint {
+		int32_t fromIdx = 0;
+		int32_t toIdx = 0;
+	};
+	std::vector<WindowHint> windowHints;
+
+	// canvas of every lane drawn in the last frame for hit testing
+	struct LaneCanvas {
+		std::weak_ptr<Funscript> script;
+		ImVec2 pos;
+		ImVec2 size;
+	};
+	std::vector<LaneCanvas> laneCanvases;
 public:
 	static constexpr const char* PositionsId = "Positions";
 
@@ -112,4 +152,10 @@ public:
 	void ShowScriptPositions(bool* open, float currentPositionMs, float durationMs, float frameTimeMs, const std::vector<std::shared_ptr<Funscript>>& scripts, Funscript* activeScript) noexcept;
 
 	void DrawAudioWaveform(const OverlayDrawingCtx& ctx) noexcept;
+
+	// renders the lanes which changed during this frame
+	// has to be called after ImGui::Render & before the imgui draw data gets rendered
+	inline void RenderCachedLanes() noexcept { laneCache.Render(); }
+
+	static void BenchmarkCulling() noexcept;
 };
\ No newline at end of file
@@ -0,0 +1,311 @@
+#include "OFS_Thumbnails.h"
+#include "OFS_Util.h"
+
+#include "reproc++/reproc.hpp"
+#include "reproc++/drain.hpp"
+
+#include "SDL_thread.h"
+#include "glad/glad.h"
+#include "stb_image.h"
+#include "stb_image_write.h"
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+constexpr size_t ThumbBytes = OFS_Thumbnails::ThumbWidth * OFS_Thumbnails::ThumbHeight * 3;
+
+int32_t OFS_Thumbnails::Strip::IntervalFor(float durationMs) noexcept
+{
+	return std::max(MinIntervalMs, (int32_t)std::ceil(durationMs / MaxThumbnails));
+}
+
+int32_t OFS_Thumbnails::Strip::RowsFor(float durationMs, int32_t intervalMs) noexcept
+{
+	// the fps filter emits one more frame than fits into the duration
+	int32_t thumbnails = std::min(MaxThumbnails, (int32_t)std::ceil(durationMs / intervalMs) + 1);
+	return (thumbnails + AtlasColumns - 1) / AtlasColumns;
+}
+
+bool OFS_Thumbnails::Strip::Generate(const std::string& ffmpegPath, const std::string& videoPath, int32_t intervalMs, Strip& output, const RowFunc& rowDone) noexcept
+{
+	output = Strip();
+	output.intervalMs = intervalMs;
+
+	// only keyframes get decoded. the fps filter repeats them at the interval
+	char filter[256];
+	stbsp_snprintf(filter, sizeof(filter),
+		"fps=1000/%d,scale=%d:%d:force_original_aspect_ratio=decrease,pad=%d:%d:(ow-iw)/2:(oh-ih)/2",
+		intervalMs, ThumbWidth, ThumbHeight, ThumbWidth, ThumbHeight);
+	std::array<const char*, 18> args =
+	{
+		ffmpegPath.c_str(),
+		"-v", "error",
+		"-skip_frame", "nokey",
+		"-i", videoPath.c_str(),
+		"-an", "-sn",
+		"-vf", filter,
+		"-f", "rawvideo",
+		"-pix_fmt", "rgb24",
+		"-",
+		nullptr
+	};
+
+	reproc::options options;
+	options.redirect.out.type = reproc::redirect::pipe;
+	options.redirect.err.type = reproc::redirect::parent;
+
+	reproc::process ffmpeg;
+	std::error_code ec = ffmpeg.start(args.data(), options);
+	if (ec) {
+		LOGF_ERROR("OFS_Thumbnails::Generate: failed to start ffmpeg. %s", ec.message().c_str());
+		return false;
+	}
+
+	// only the row which is being filled is kept uncompressed
+	std::vector<uint8_t> rowPixels(RowBytes, 0);
+	auto finishRow = [&]() {
+		int32_t row = (int32_t)output.rows.size();
+		auto& jpg = output.rows.emplace_back();
+		// rows are filled top down already. stb's flip flag is global & shared with other threads
+		// so nothing in OFS calls stbi_flip_vertically_on_write
+		stbi_write_jpg_to_func([](void* ctx, void* data, int size) {
+			auto& jpg = *(std::vector<uint8_t>*)ctx;
+			jpg.insert(jpg.end(), (uint8_t*)data, (uint8_t*)data + size);
+		}, &jpg, AtlasWidth, ThumbHeight, 3, rowPixels.data(), JpgQuality);
+		if (rowDone) { rowDone(output, row, rowPixels.data()); }
+		std::fill(rowPixels.begin(), rowPixels.end(), 0);
+	};
+
+	// frames arrive in arbitrary chunks & get copied into their atlas cell once complete
+	std::vector<uint8_t> frame;
+	frame.reserve(ThumbBytes);
+	auto frameSink = [&](reproc::stream stream, const uint8_t* buffer, size_t size) -> std::error_code {
+		while (size > 0) {
+			size_t take = std::min(size, ThumbBytes - frame.size());
+			frame.insert(frame.end(), buffer, buffer + take);
+			buffer += take;
+			size -= take;
+			if (frame.size() < ThumbBytes) break;
+
+			if (output.count < MaxThumbnails) {
+				int32_t idx = output.count++;
+				int32_t x = (idx % AtlasColumns) * ThumbWidth;
+				for (int32_t row = 0; row < ThumbHeight; row++) {
+					std::memcpy(&rowPixels[((size_t)row * AtlasWidth + x) * 3], &frame[(size_t)row * ThumbWidth * 3], ThumbWidth * 3);
+				}
+				if (output.count % AtlasColumns == 0) {
+					finishRow();
+				}
+			}
+			frame.clear();
+		}
+		return {};
+	};
+	ec = reproc::drain(ffmpeg, frameSink, reproc::sink::null);
+	if (ec) {
+		LOGF_ERROR("OFS_Thumbnails::Generate: %s", ec.message().c_str());
+	}
+	if (output.count % AtlasColumns != 0) {
+		finishRow();
+	}
+
+	int status = 0;
+	std::tie(status, ec) = ffmpeg.wait(reproc::infinite);
+	if (ec || status != 0 || output.count == 0) {
+		LOGF_ERROR("OFS_Thumbnails::Generate: ffmpeg failed. status: %d %s", status, ec.message().c_str());
+		return false;
+	}
+	return true;
+}
+
+bool OFS_Thumbnails::Strip::DecodeRow(int32_t row, uint8_t* pixels) const noexcept
+{
+	if (row < 0 || row >= rows.size()) return false;
+	auto& jpg = rows[row];
+	int w = 0, h = 0;
+	stbi_uc* data = stbi_load_from_memory(jpg.data(), jpg.size(), &w, &h, nullptr, 3);
+	if (data == nullptr) return false;
+	bool succ = w == AtlasWidth && h == ThumbHeight;
+	if (succ) {
+		std::memcpy(pixels, data, RowBytes);
+	}
+	stbi_image_free(data);
+	return succ;
+}
+
+// ===== cache =====
+
+struct ThumbnailCacheHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t thumbWidth;
+	uint32_t thumbHeight;
+	uint32_t columns;
+	int32_t intervalMs;
+	int32_t count;
+	uint32_t padding;
+	uint64_t pathHash;
+	uint64_t mediaSize;
+	int64_t mediaMtime;
+	uint64_t contentHash;
+};
+static_assert(sizeof(ThumbnailCacheHeader) == 64);
+constexpr char ThumbnailCacheMagic[4] = { 'O', 'F', 'S', 'T' };
+constexpr uint32_t ThumbnailCacheVersion = 2;
+
+bool OFS_Thumbnails::Strip::SaveCache(const OFS_MediaCacheKey& key) const noexcept
+{
+	if (count == 0 || rows.size() != Rows()) return false;
+	auto cachePath = Util::PathFromString(key.CachePath("thumbnails", "ofsthumb"));
+	if (!Util::CreateDirectories(cachePath.parent_path())) return false;
+
+	ThumbnailCacheHeader header = {};
+	std::copy(std::begin(ThumbnailCacheMagic), std::end(ThumbnailCacheMagic), header.magic);
+	header.version = ThumbnailCacheVersion;
+	header.thumbWidth = ThumbWidth;
+	header.thumbHeight = ThumbHeight;
+	header.columns = AtlasColumns;
+	header.intervalMs = intervalMs;
+	header.count = count;
+	header.pathHash = key.pathHash;
+	header.mediaSize = key.mediaSize;
+	header.mediaMtime = key.mediaMtime;
+	header.contentHash = key.contentHash;
+
+	// a task of a reopened video might still be writing the same cache
+	auto tmpPath = cachePath;
+	tmpPath.replace_extension("." + std::to_string(SDL_ThreadID()) + ".tmp");
+	auto handle = SDL_RWFromFile(tmpPath.u8string().c_str(), "wb");
+	if (handle == nullptr) {
+		LOGF_ERROR("Failed to write thumbnail cache: %s", SDL_GetError());
+		return false;
+	}
+	// every row is prefixed with its size
+	bool succ = SDL_RWwrite(handle, &header, sizeof(header), 1) == 1;
+	for (auto& jpg : rows) {
+		if (!succ) break;
+		uint32_t size = jpg.size();
+		succ = SDL_RWwrite(handle, &size, sizeof(size), 1) == 1
+			&& SDL_RWwrite(handle, jpg.data(), 1, jpg.size()) == jpg.size();
+	}
+	SDL_RWclose(handle);
+
+	std::error_code ec;
+	if (succ) {
+		std::filesystem::rename(tmpPath, cachePath, ec);
+		if (ec) {
+			LOGF_ERROR("Failed to write thumbnail cache: %s", ec.message().c_str());
+			succ = false;
+		}
+	}
+	if (!succ) {
+		std::filesystem::remove(tmpPath, ec);
+	}
+	return succ;
+}
+
+bool OFS_Thumbnails::Strip::LoadCache(const OFS_MediaCacheKey& key) noexcept
+{
+	*this = Strip();
+	auto handle = SDL_RWFromFile(key.CachePath("thumbnails", "ofsthumb").c_str(), "rb");
+	if (handle == nullptr) return false;
+
+	ThumbnailCacheHeader header;
+	bool valid = SDL_RWread(handle, &header, sizeof(header), 1) == 1
+		&& std::equal(std::begin(ThumbnailCacheMagic), std::end(ThumbnailCacheMagic), header.magic)
+		&& header.version == ThumbnailCacheVersion
+		&& header.thumbWidth == ThumbWidth
+		&& header.thumbHeight == ThumbHeight
+		&& header.columns == AtlasColumns
+		&& header.pathHash == key.pathHash
+		&& header.mediaSize == key.mediaSize
+		&& header.mediaMtime == key.mediaMtime
+		&& header.contentHash == key.contentHash
+		&& header.count > 0 && header.count <= MaxThumbnails
+		&& header.intervalMs > 0;
+	if (valid) {
+		count = header.count;
+		intervalMs = header.intervalMs;
+		rows.resize(Rows());
+		for (auto& jpg : rows) {
+			uint32_t size = 0;
+			valid = SDL_RWread(handle, &size, sizeof(size), 1) == 1 && size > 0 && size <= RowBytes;
+			if (!valid) break;
+			jpg.resize(size);
+			valid = SDL_RWread(handle, jpg.data(), 1, jpg.size()) == jpg.size();
+			if (!valid) break;
+		}
+	}
+	SDL_RWclose(handle);
+	if (!valid) {
+		*this = Strip();
+	}
+	return valid;
+}
+
+// ===== atlas =====
+
+void OFS_Thumbnails::UploadRow(const uint8_t* rowPixels, int32_t row, int32_t capacityRows, int32_t intervalMs) noexcept
+{
+	if (complete || row < 0 || row >= capacityRows) return;
+	if (atlasTexture == 0 || rows != capacityRows) {
+		Clear();
+		rows = capacityRows;
+		glGenTextures(1, &atlasTexture);
+		glBindTexture(GL_TEXTURE_2D, atlasTexture);
+		// linear minification would blend in the neighbouring cells
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, AtlasWidth, rows * ThumbHeight, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+	}
+	else {
+		glBindTexture(GL_TEXTURE_2D, atlasTexture);
+	}
+	this->intervalMs = intervalMs;
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, row * ThumbHeight, AtlasWidth, ThumbHeight, GL_RGB, GL_UNSIGNED_BYTE, rowPixels);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	// rows arrive in order
+	count = std::max(count, (row + 1) * AtlasColumns);
+}
+
+void OFS_Thumbnails::Finish(int32_t count) noexcept
+{
+	if (atlasTexture == 0) return;
+	// thumbnails which didn't fit into the atlas are past the end of the video anyway
+	this->count = std::min(count, rows * AtlasColumns);
+	complete = true;
+}
+
+void OFS_Thumbnails::Clear() noexcept
+{
+	if (atlasTexture != 0) {
+		glDeleteTextures(1, &atlasTexture);
+		atlasTexture = 0;
+	}
+	count = 0;
+	rows = 0;
+	intervalMs = 0;
+	complete = false;
+}
+
+bool OFS_Thumbnails::Lookup(float timeMs, ImVec2* uv0, ImVec2* uv1) const noexcept
+{
+	if (count == 0) return false;
+	int32_t idx = std::max<int32_t>(0, std::round(timeMs / intervalMs));
+	if (idx >= count) {
+		if (!complete) return false;
+		idx = count - 1;
+	}
+	const ImVec2 size(1.f / AtlasColumns, 1.f / rows);
+	// half a texel inset keeps the linear magnification inside of the cell
+	const ImVec2 inset(0.5f / AtlasWidth, 0.5f / (rows * ThumbHeight));
+	*uv0 = ImVec2((idx % AtlasColumns) * size.x + inset.x, (idx / AtlasColumns) * size.y + inset.y);
+	*uv1 = ImVec2(uv0->x + size.x - 2.f * inset.x, uv0->y + size.y - 2.f * inset.y);
+	return true;
+}
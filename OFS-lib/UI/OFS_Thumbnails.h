@@ -0,0 +1,76 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <functional>
+
+#include "OFS_MediaCacheKey.h"
+
+#include "imgui.h"
+
+// low resolution keyframes of a video at a fixed interval packed into one texture atlas
+// generated by ffmpeg in the background & cached on disk per video
+class OFS_Thumbnails
+{
+public:
+	static constexpr int32_t ThumbWidth = 128;
+	static constexpr int32_t ThumbHeight = 72;
+	static constexpr int32_t AtlasColumns = 32;
+	static constexpr int32_t AtlasWidth = AtlasColumns * ThumbWidth;
+	// a 4096x2304 atlas. longer videos get a wider interval
+	static constexpr int32_t MaxThumbnails = AtlasColumns * 32;
+	static constexpr int32_t MinIntervalMs = 2000;
+	static constexpr int32_t JpgQuality = 85;
+
+	static constexpr size_t RowBytes = (size_t)AtlasWidth * ThumbHeight * 3;
+
+	// atlas rows compressed as jpeg. this is what gets generated & cached
+	struct Strip {
+		std::vector<std::vector<uint8_t>> rows;
+		int32_t count = 0;
+		int32_t intervalMs = 0;
+
+		inline int32_t Rows() const noexcept { return (count + AtlasColumns - 1) / AtlasColumns; }
+		// decodes a row into RowBytes of rgb24
+		bool DecodeRow(int32_t row, uint8_t* pixels) const noexcept;
+
+		// called on the generating thread whenever a row of the atlas is complete
+		// the last row is passed on as well even if it isn't full
+		using RowFunc = std::function<void(const Strip& strip, int32_t row, const uint8_t* pixels)>;
+
+		// picks an interval so that the whole video fits into MaxThumbnails
+		static int32_t IntervalFor(float durationMs) noexcept;
+		static int32_t RowsFor(float durationMs, int32_t intervalMs) noexcept;
+		static bool Generate(const std::string& ffmpegPath, const std::string& videoPath, int32_t intervalMs, Strip& output, const RowFunc& rowDone = nullptr) noexcept;
+
+		bool SaveCache(const OFS_MediaCacheKey& key) const noexcept;
+		bool LoadCache(const OFS_MediaCacheKey& key) noexcept;
+	};
+private:
+	unsigned int atlasTexture = 0;
+	int32_t count = 0;
+	int32_t rows = 0;
+	int32_t intervalMs = 0;
+	// false while rows are still arriving
+	bool complete = false;
+public:
+	OFS_Thumbnails() noexcept {}
+	~OFS_Thumbnails() noexcept { Clear(); }
+
+	OFS_Thumbnails(const OFS_Thumbnails&) = delete;
+	OFS_Thumbnails& operator=(const OFS_Thumbnails&) = delete;
+
+	// main thread only
+	// fills in a single row of an atlas which has room for capacityRows
+	void UploadRow(const uint8_t* rowPixels, int32_t row, int32_t capacityRows, int32_t intervalMs) noexcept;
+	// every row was uploaded. count is the exact number of thumbnails
+	void Finish(int32_t count) noexcept;
+	void Clear() noexcept;
+
+	inline bool Ready() const noexcept { return atlasTexture != 0; }
+	inline ImTextureID Texture() const noexcept { return (ImTextureID)(intptr_t)atlasTexture; }
+
+	// uv rect of the thumbnail closest to timeMs. false if it wasn't generated yet
+	bool Lookup(float timeMs, ImVec2* uv0, ImVec2* uv1) const noexcept;
+};
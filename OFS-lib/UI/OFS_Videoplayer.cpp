@@ -9,6 +9,7 @@
 #include <mpv/render_gl.h>
 
 #include <cstdlib>
+#include <cmath>
 #include <filesystem>
 #include <sstream>
 
@@ -88,6 +89,16 @@ void VideoplayerWindow::MpvEvents(SDL_Event& ev) noexcept
 			MpvData.video_loaded = true; 	
 			continue;
 		}
+		case MPV_EVENT_PLAYBACK_RESTART:
+		{
+			if (frameExport.seeking) {
+				// the frame which gets rendered next is the one seeked to
+				frameExport.seekDone = true;
+				frameExport.rendered = false;
+				redraw_video = true;
+			}
+			continue;
+		}
 		case MPV_EVENT_PROPERTY_CHANGE:
 		{
 			mpv_event_property* prop = (mpv_event_property*)mp_event->data;
@@ -153,15 +164,22 @@ void VideoplayerWindow::MpvEvents(SDL_Event& ev) noexcept
 				MpvData.real_percent_pos = (*(double*)prop->data) / 100.0;
 				if (!MpvData.paused) {
 					MpvData.percent_pos = MpvData.real_percent_pos;
+					if (!hasAudioPts) { clock.Observe(getCurrentPositionSeconds()); }
+				}
+				break;
+			case MpvAudioPts:
+				hasAudioPts = true;
+				if (!MpvData.paused) {
+					clock.Observe(*(double*)prop->data);
 				}
-				smooth_time = std::chrono::high_resolution_clock::now();
 				break;
 			case MpvSpeed:
 				MpvData.current_speed = *(double*)prop->data;
+				clock.SetSpeed(MpvData.current_speed);
 				break;
 			case MpvPauseState:
 				MpvData.paused = *(int64_t*)prop->data;
-				smooth_time = std::chrono::high_resolution_clock::now();
+				clock.SetPaused(MpvData.paused, getCurrentPositionSeconds());
 				EventSystem::PushEvent(VideoEvents::PlayPauseChanged, (void*)(intptr_t)MpvData.paused);
 				break;
 			case MpvFilePath:
@@ -169,6 +187,7 @@ void VideoplayerWindow::MpvEvents(SDL_Event& ev) noexcept
 				// But I can't free it so I will assume I don't
 				MpvData.file_path = *((const char**)(prop->data));
 				notifyVideoLoaded();
+				startFrameIndexTask();
 				break;
 			case MpvAbLoopA:
 			{
@@ -214,13 +233,17 @@ void VideoplayerWindow::observeProperties() noexcept
 	mpv_observe_property(mpv, MpvFramesPerSecond, "estimated-vf-fps", MPV_FORMAT_DOUBLE);
 	mpv_observe_property(mpv, MpvAbLoopA, "ab-loop-a", MPV_FORMAT_DOUBLE);
 	mpv_observe_property(mpv, MpvAbLoopB, "ab-loop-b", MPV_FORMAT_DOUBLE);
+	mpv_observe_property(mpv, MpvAudioPts, "audio-pts", MPV_FORMAT_DOUBLE);
 }
 
 void VideoplayerWindow::renderToTexture() noexcept
 {
 	redraw_video = false;
+	// never render into the texture the gui samples or the one waiting to be displayed
+	int32_t target = (displayedTarget + 1) % RenderTargetCount;
+	if (target == pendingTarget) { target = (target + 1) % RenderTargetCount; }
 	mpv_opengl_fbo fbo{ 0 };
-	fbo.fbo = framebuffer_obj; fbo.w = MpvData.video_width; fbo.h = MpvData.video_height;
+	fbo.fbo = renderTargets[target].framebuffer; fbo.w = renderTargetWidth; fbo.h = renderTargetHeight;
 	int enable = 1;
 	int disable = 0;
 	mpv_render_param params[] = {
@@ -230,40 +253,111 @@ void VideoplayerWindow::renderToTexture() noexcept
 		{MPV_RENDER_PARAM_BLOCK_FOR_TARGET_TIME, &disable}, 
 		mpv_render_param{}
 	};
+	if (GpuTimer != nullptr) GpuTimer->Begin(OFS_GpuTimer::MpvRender);
 	mpv_render_context_render(mpv_gl, params);
+	if (GpuTimer != nullptr) GpuTimer->End(OFS_GpuTimer::MpvRender);
+	// a newer frame replaces the one which is still pending
+	if (pendingFence != nullptr) { glDeleteSync(pendingFence); }
+	pendingFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	pendingTarget = target;
+	frameExport.rendered = true;
+}
+
+void VideoplayerWindow::presentRenderTarget() noexcept
+{
+	if (pendingFence == nullptr) return;
+	GLenum status = glClientWaitSync(pendingFence, 0, 0);
+	if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED) {
+		glDeleteSync(pendingFence);
+		pendingFence = nullptr;
+		displayedTarget = pendingTarget;
+		pendingTarget = -1;
+	}
+}
+
+void VideoplayerWindow::destroyRenderTargets() noexcept
+{
+	if (pendingFence != nullptr) {
+		glDeleteSync(pendingFence);
+		pendingFence = nullptr;
+	}
+	pendingTarget = -1;
+	for (auto& target : renderTargets) {
+		if (target.framebuffer != 0) glDeleteFramebuffers(1, &target.framebuffer);
+		if (target.texture != 0) glDeleteTextures(1, &target.texture);
+		target = RenderTarget();
+	}
+	renderTargetWidth = 0;
+	renderTargetHeight = 0;
 }
 
-void VideoplayerWindow::updateRenderTexture() noexcept
+float VideoplayerWindow::renderScale() const noexcept
 {
-	if (framebuffer_obj == 0) {
-		glGenFramebuffers(1, &framebuffer_obj);
-		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_obj);
+	// full resolution while paused so every detail is there for scripting & exports
+	if (!settings.proxyPlayback || MpvData.paused || frameExport.active || !pendingScreenshot.empty()) return 1.f;
+	if (MpvData.video_width <= 0 || video_draw_size.x <= 0.f) return 1.f;
 
-		glGenTextures(1, &render_texture);
-		glBindTexture(GL_TEXTURE_2D, render_texture);
-		const int default_width = 1920;
-		const int default_height = 1080;
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, default_width, default_height, 0, GL_RGB, GL_UNSIGNED_BYTE, 0);
+	// the pane size is in points
+	const float framebufferScale = ImGui::GetIO().DisplayFramebufferScale.x;
+	float scale;
+	if (settings.activeMode == VideoMode::VR_MODE) {
+		// the texture spans 360 degrees horizontally while the pane only shows the view angle
+		scale = video_draw_size.x * framebufferScale * (2.f * IM_PI / VrShader::ViewAngle(settings.vr_zoom)) / MpvData.video_width;
+	}
+	else {
+		scale = base_scale_factor * settings.zoom_factor * framebufferScale;
+	}
+	// steps prevent resizing the pane from recreating the targets every frame
+	scale = std::ceil(scale * ProxyScaleSteps) / ProxyScaleSteps;
+	return Util::Clamp(scale, 1.f / ProxyScaleSteps, 1.f);
+}
 
+bool VideoplayerWindow::updateRenderTexture() noexcept
+{
+	int32_t width = 1920;
+	int32_t height = 1080;
+	if (MpvData.video_width > 0 && MpvData.video_height > 0) {
+		const float scale = renderScale();
+		width = std::max<int32_t>(1, std::round(MpvData.video_width * scale));
+		height = std::max<int32_t>(1, std::round(MpvData.video_height * scale));
+	}
+	if (renderTargets[0].framebuffer != 0 && width == renderTargetWidth && height == renderTargetHeight) return false;
+
+	// immutable textures can't be resized, they get recreated instead
+	destroyRenderTargets();
+
+	GLint prevFramebuffer = 0, prevTexture = 0;
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prevFramebuffer);
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &prevTexture);
+	for (auto& target : renderTargets) {
+		glGenTextures(1, &target.texture);
+		glBindTexture(GL_TEXTURE_2D, target.texture);
+		if (GLAD_GL_ARB_texture_storage) {
+			glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, width, height);
+		}
+		else {
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+		}
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
 
-		// Set "renderedTexture" as our colour attachement #0
-		glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, render_texture, 0);
-
-		// Set the list of draw buffers.
+		glGenFramebuffers(1, &target.framebuffer);
+		glBindFramebuffer(GL_FRAMEBUFFER, target.framebuffer);
+		glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, target.texture, 0);
 		GLenum DrawBuffers[1] = { GL_COLOR_ATTACHMENT0 };
-		glDrawBuffers(1, DrawBuffers); 
+		glDrawBuffers(1, DrawBuffers);
 
 		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
 			LOG_ERROR("Failed to create framebuffer for video!");
 		}
 	}
-	else {
-		// update size of render texture based on video resolution
-		glBindTexture(GL_TEXTURE_2D, render_texture);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, MpvData.video_width, MpvData.video_height, 0, GL_RGB, GL_UNSIGNED_BYTE, 0);
-	}
+	glBindFramebuffer(GL_FRAMEBUFFER, prevFramebuffer);
+	glBindTexture(GL_TEXTURE_2D, prevTexture);
+	renderTargetWidth = width;
+	renderTargetHeight = height;
+	displayedTarget = 0;
+	return true;
 }
 
 bool VideoplayerWindow::setup(bool force_hw_decoding)
@@ -347,10 +441,10 @@ bool VideoplayerWindow::setup(bool force_hw_decoding)
 
 VideoplayerWindow::~VideoplayerWindow()
 {
+	frameExporter.Shutdown();
 	mpv_render_context_free(mpv_gl);
 	mpv_detach_destroy(mpv);
-	glDeleteTextures(1, &render_texture);
-	glDeleteFramebuffers(1, &framebuffer_obj);
+	destroyRenderTargets();
 	EventSystem::ev().UnsubscribeAll(this);
 }
 
@@ -420,6 +514,44 @@ void VideoplayerWindow::notifyVideoLoaded() noexcept
 	SDL_PushEvent(&ev);
 }
 
+void VideoplayerWindow::startFrameIndexTask() noexcept
+{
+	if (MpvData.file_path == nullptr) return;
+	auto indexFrames = [](void* user) -> int {
+		auto task = (FrameIndexTask*)user;
+		OFS_MediaCacheKey key;
+		bool hasKey = OFS_MediaCacheKey::FromMedia(task->videoPath, key);
+		if (hasKey && task->index.LoadCache(key)) {
+			LOGF_INFO("Loaded cached frame index for \"%s\"", task->videoPath.c_str());
+		}
+		else {
+			auto ffmpegPath = Util::FfmpegPath();
+			if (OFS_FrameIndex::Generate(ffmpegPath.u8string(), task->videoPath, task->index) && hasKey) {
+				task->index.SaveCache(key);
+			}
+		}
+		EventSystem::SingleShot([](void* ctx) {
+			auto task = (FrameIndexTask*)ctx;
+			task->player->applyFrameIndexTask(task);
+		}, task);
+		return 0;
+	};
+	auto task = new FrameIndexTask();
+	task->player = this;
+	task->videoPath = MpvData.file_path;
+	auto handle = SDL_CreateThread(indexFrames, "OFS_IndexFrames", task);
+	SDL_DetachThread(handle);
+}
+
+void VideoplayerWindow::applyFrameIndexTask(FrameIndexTask* task) noexcept
+{
+	// the video might have changed in the meantime
+	if (MpvData.file_path != nullptr && task->videoPath == MpvData.file_path) {
+		frameIndex = std::move(task->index);
+	}
+	delete task;
+}
+
 void VideoplayerWindow::drawVrVideo(ImDrawList* draw_list) noexcept
 {
 	if (!settings.LockedPosition && videoHovered && ImGui::IsMouseClicked(ImGuiMouseButton_Left) && !dragStarted) {
@@ -435,6 +567,15 @@ void VideoplayerWindow::drawVrVideo(ImDrawList* draw_list) noexcept
 	}
 
 	player_viewport = ImGui::GetCurrentWindowRead()->Viewport;
+	// the queries belong to the main context. other viewports render with their own
+	const bool timeVrShader = GpuTimer != nullptr && player_viewport == ImGui::GetMainViewport();
+	if (timeVrShader) {
+		draw_list->AddCallback(
+			[](const ImDrawList* parent_list, const ImDrawCmd* cmd) {
+				auto& ctx = *(VideoplayerWindow*)cmd->UserCallbackData;
+				ctx.GpuTimer->Begin(OFS_GpuTimer::VrShader);
+			}, this);
+	}
 	draw_list->AddCallback(
 		[](const ImDrawList* parent_list, const ImDrawCmd* cmd) {
 			auto& ctx = *(VideoplayerWindow*)cmd->UserCallbackData;
@@ -462,8 +603,14 @@ void VideoplayerWindow::drawVrVideo(ImDrawList* draw_list) noexcept
 				ctx.vr_shader->VideoAspectRatio(ctx.MpvData.video_width /(float)ctx.MpvData.video_height);
 			}
 		}, this);
-	//ImGui::Image((void*)(intptr_t)render_texture, ImGui::GetContentRegionAvail(), ImVec2(0.f, 1.f),	ImVec2(1.f, 0.f));
-	OFS::ImageWithId(ImGui::GetID("videoImage"), (void*)(intptr_t)render_texture, ImGui::GetContentRegionAvail(), ImVec2(0.f, 1.f), ImVec2(1.f, 0.f));
+	OFS::ImageWithId(ImGui::GetID("videoImage"), (void*)(intptr_t)displayedTexture(), ImGui::GetContentRegionAvail(), ImVec2(0.f, 1.f), ImVec2(1.f, 0.f));
+	if (timeVrShader) {
+		draw_list->AddCallback(
+			[](const ImDrawList* parent_list, const ImDrawCmd* cmd) {
+				auto& ctx = *(VideoplayerWindow*)cmd->UserCallbackData;
+				ctx.GpuTimer->End(OFS_GpuTimer::VrShader);
+			}, this);
+	}
 	videoRightClickMenu();
 	video_draw_size = ImGui::GetItemRectSize();
 }
@@ -516,8 +663,7 @@ void VideoplayerWindow::draw2dVideo(ImDrawList* draw_list) noexcept
 	{
 		settings.current_translation = settings.prev_translation + ImGui::GetMouseDragDelta(ImGuiMouseButton_Left);
 	}
-	//ImGui::Image((void*)(intptr_t)render_texture, videoSize, uv0, uv1);
-	OFS::ImageWithId(ImGui::GetID("videoImage"), (void*)(intptr_t)render_texture, videoSize, uv0, uv1);
+	OFS::ImageWithId(ImGui::GetID("videoImage"), (void*)(intptr_t)displayedTexture(), videoSize, uv0, uv1);
 	videoRightClickMenu();
 }
 
@@ -526,6 +672,8 @@ void VideoplayerWindow::videoRightClickMenu() noexcept
 	if (ImGui::BeginPopupContextItem())
 	{
 		ImGui::MenuItem("Lock", NULL, &settings.LockedPosition);
+		ImGui::MenuItem("Proxy resolution while playing", NULL, &settings.proxyPlayback);
+		Util::Tooltip("Renders the video at the size it's shown at.\nSwitches back to full resolution when paused.");
 
 
 #ifndef NDEBUG
@@ -560,8 +708,16 @@ void VideoplayerWindow::clearLoop() noexcept
 
 void VideoplayerWindow::DrawVideoPlayer(bool* open, bool* draw_video) noexcept
 {
+	// switching between proxy & full resolution needs the current frame rendered again
+	if (MpvData.video_loaded && updateRenderTexture()) { redraw_video = true; }
+	presentRenderTarget();
 	// this redraw has to happen even if the video isn't actually shown in the gui
 	if (redraw_video) { renderToTexture(); }
+	if (!pendingScreenshot.empty() && renderTargetWidth == MpvData.video_width && renderTargetHeight == MpvData.video_height) {
+		frameExporter.Capture(latestFramebuffer(), renderTargetWidth, renderTargetHeight, pendingScreenshot, OFS_FrameExporter::Format::Png);
+		pendingScreenshot.clear();
+	}
+	updateFrameExport();
 	if (open != nullptr && !*open) return;
 	ImGui::Begin(PlayerId, open, ImGuiWindowFlags_None | ImGuiWindowFlags_NoScrollWithMouse | ImGuiWindowFlags_NoScrollbar);
 
@@ -637,6 +793,9 @@ void VideoplayerWindow::openVideo(const std::string& file)
 	newCache.current_speed = MpvData.current_speed;
 	newCache.paused = MpvData.paused;
 	MpvData = newCache;
+	frameIndex.Clear();
+	hasAudioPts = false;
+	clock.Reset(0.0);
 
 	setPaused(true);
 	setVolume(settings.volume);
@@ -644,25 +803,81 @@ void VideoplayerWindow::openVideo(const std::string& file)
 	resetTranslationAndZoom();
 }
 
-void VideoplayerWindow::saveFrameToImage(const std::string& directory)
+std::string VideoplayerWindow::frameFilename(const std::string& directory, double seconds, OFS_FrameExporter::Format format) noexcept
 {
 	std::stringstream ss;
 	std::filesystem::path currentFile(getVideoPath());
 	std::string filename = currentFile.filename().replace_extension("").string();
 	std::array<char, 15> tmp;
-	double time = getCurrentPositionSeconds();
-	Util::FormatTime(tmp.data(), tmp.size(), time, true);
+	Util::FormatTime(tmp.data(), tmp.size(), seconds, true);
 	std::replace(tmp.begin(), tmp.end(), ':', '_');
 
-	ss << filename << '_' << tmp.data() << ".png";
+	ss << filename << '_' << tmp.data() << (format == OFS_FrameExporter::Format::Jpg ? ".jpg" : ".png");
+	std::filesystem::path dir(directory);
+	dir.make_preferred();
+	return (dir / ss.str()).string();
+}
+
+void VideoplayerWindow::saveFrameToImage(const std::string& directory)
+{
+	if (!isLoaded() || MpvData.video_width <= 0 || MpvData.video_height <= 0) return;
 	if(!Util::CreateDirectories(directory)) {
 		return;
 	}
-	std::filesystem::path dir(directory);
-	dir.make_preferred();
-	std::string finalPath = (dir / ss.str()).string();
-	const char* cmd[]{ "screenshot-to-file", finalPath.c_str(), NULL };
-	mpv_command_async(mpv, 0, cmd);
+	// the newest frame might not be displayed yet but it's the one at the current position
+	auto finalPath = frameFilename(directory, getCurrentPositionSeconds(), OFS_FrameExporter::Format::Png);
+	if (renderTargetWidth != MpvData.video_width || renderTargetHeight != MpvData.video_height) {
+		// proxy playback. the frame gets rendered at full resolution first
+		pendingScreenshot = std::move(finalPath);
+		return;
+	}
+	frameExporter.Capture(latestFramebuffer(), renderTargetWidth, renderTargetHeight, finalPath, OFS_FrameExporter::Format::Png);
+}
+
+void VideoplayerWindow::exportFrames(std::vector<int32_t>&& timesMs, const std::string& directory, OFS_FrameExporter::Format format) noexcept
+{
+	if (!isLoaded() || timesMs.empty()) return;
+	if (!Util::CreateDirectories(directory)) {
+		return;
+	}
+	frameExport = FrameExportState();
+	frameExport.timesMs = std::move(timesMs);
+	frameExport.directory = directory;
+	frameExport.format = format;
+	frameExport.active = true;
+	setPaused(true);
+	LOGF_INFO("Exporting %zu frames to \"%s\"", frameExport.timesMs.size(), directory.c_str());
+}
+
+void VideoplayerWindow::cancelFrameExport() noexcept
+{
+	frameExport.active = false;
+	frameExport.seeking = false;
+}
+
+void VideoplayerWindow::updateFrameExport() noexcept
+{
+	frameExporter.Update();
+	if (!frameExport.active) return;
+
+	if (frameExport.seeking) {
+		if (!frameExport.seekDone || !frameExport.rendered) return;
+		int32_t timeMs = frameExport.timesMs[frameExport.next];
+		auto finalPath = frameFilename(frameExport.directory, timeMs / 1000.0, frameExport.format);
+		frameExporter.Capture(latestFramebuffer(), renderTargetWidth, renderTargetHeight, finalPath, frameExport.format);
+		frameExport.next++;
+		frameExport.seeking = false;
+	}
+
+	if (frameExport.next >= frameExport.timesMs.size()) {
+		LOGF_INFO("Exported %zu frames.", frameExport.next);
+		frameExport.active = false;
+		return;
+	}
+	frameExport.seeking = true;
+	frameExport.seekDone = false;
+	frameExport.rendered = false;
+	setPositionExact(frameExport.timesMs[frameExport.next], true);
 }
 
 void VideoplayerWindow::setVolume(float volume) noexcept
@@ -675,6 +890,7 @@ void VideoplayerWindow::setVolume(float volume) noexcept
 void VideoplayerWindow::setPositionPercent(float pos, bool pausesVideo) noexcept
 {
 	MpvData.percent_pos = pos;
+	clock.Reset(getCurrentPositionSeconds());
 	stbsp_snprintf(tmp_buf, sizeof(tmp_buf), "%.08f", (float)(pos * 100.0f));
 	const char* cmd[]{ "seek", tmp_buf, "absolute-percent+exact", NULL };
 	if (pausesVideo) {
@@ -697,9 +913,23 @@ void VideoplayerWindow::setPaused(bool paused) noexcept
 	mpv_set_property_async(mpv, 0, "pause", MPV_FORMAT_FLAG, &MpvData.paused);
 }
 
+void VideoplayerWindow::seekToFrame(int64_t frame) noexcept
+{
+	double seconds = frameIndex.FrameTime(frame);
+	MpvData.percent_pos = Util::Clamp(seconds / MpvData.duration, 0.0, 1.0);
+	clock.Reset(seconds);
+	// a hair past the timestamp so that mpv doesn't land on the previous frame
+	stbsp_snprintf(tmp_buf, sizeof(tmp_buf), "%.06f", seconds + OFS_FrameIndex::Epsilon);
+	const char* cmd[]{ "seek", tmp_buf, "absolute+exact", NULL };
+	mpv_command_async(mpv, 0, cmd);
+}
+
 void VideoplayerWindow::nextFrame() noexcept
 {
-	if (isPaused()) {
+	if (isPaused() && !frameIndex.Empty()) {
+		seekToFrame(frameIndex.FrameAt(getCurrentPositionSeconds()) + 1);
+	}
+	else if (isPaused()) {
 		// use same method as previousFrame for consistency
 		double relSeek = ((getFrameTimeMs() * 1.000001) / 1000.);
 		MpvData.percent_pos += (relSeek / MpvData.duration);
@@ -710,7 +940,10 @@ void VideoplayerWindow::nextFrame() noexcept
 
 void VideoplayerWindow::previousFrame() noexcept
 {
-	if (isPaused()) {
+	if (isPaused() && !frameIndex.Empty()) {
+		seekToFrame(frameIndex.FrameAt(getCurrentPositionSeconds()) - 1);
+	}
+	else if (isPaused()) {
 		// this seeks much faster
 		// https://github.com/mpv-player/mpv/issues/4019#issuecomment-358641908
 		double relSeek = ((getFrameTimeMs() * 1.000001) / 1000.);
@@ -722,7 +955,10 @@ void VideoplayerWindow::previousFrame() noexcept
 
 void VideoplayerWindow::relativeFrameSeek(int32_t seek) noexcept
 {
-	if (isPaused()) {
+	if (isPaused() && !frameIndex.Empty()) {
+		seekToFrame(frameIndex.FrameAt(getCurrentPositionSeconds()) + seek);
+	}
+	else if (isPaused()) {
 		float relSeek = ((getFrameTimeMs() * 1.000001f) / 1000.f) * seek;
 		MpvData.percent_pos += (relSeek / MpvData.duration);
 		MpvData.percent_pos = Util::Clamp(MpvData.percent_pos, 0.0, 1.0);
@@ -6,9 +6,13 @@
 #include "OFS_Reflection.h"
 #include "OFS_Util.h"
 #include "OFS_Shader.h"
+#include "OFS_FrameIndex.h"
+#include "OFS_FrameExporter.h"
+#include "OFS_PlaybackClock.h"
+#include "OFS_GpuTimer.h"
 
 #include <string>
-#include <chrono>
+#include <array>
 
 #include "SDL_events.h"
 
@@ -45,15 +49,41 @@ private:
 	mpv_handle* mpv;
 	mpv_render_context* mpv_gl;
 	bool redraw_video = false;
-	uint32_t framebuffer_obj = 0;
-	uint32_t render_texture = 0;
-	
-	struct ScreenshotSavingThreadData {
-		int w;
-		int h;
-		uint8_t* dataBuffer = nullptr;
-		std::string filename;
+
+	// mpv renders into a free target while the gui still samples the displayed one
+	// a rendered target only gets displayed once its fence signaled
+	static constexpr int32_t RenderTargetCount = 3;
+	struct RenderTarget {
+		uint32_t framebuffer = 0;
+		uint32_t texture = 0;
 	};
+	std::array<RenderTarget, RenderTargetCount> renderTargets;
+	int32_t displayedTarget = 0;
+	// -1 if there's no frame waiting for the gpu
+	int32_t pendingTarget = -1;
+	GLsync pendingFence = nullptr;
+	int32_t renderTargetWidth = 0;
+	int32_t renderTargetHeight = 0;
+	inline uint32_t displayedTexture() const noexcept { return renderTargets[displayedTarget].texture; }
+	// the newest frame even if it's still pending. gl orders reads after the render
+	inline uint32_t latestFramebuffer() const noexcept { return renderTargets[pendingTarget >= 0 ? pendingTarget : displayedTarget].framebuffer; }
+	// proxy resolutions are multiples of this fraction of the video size
+	static constexpr float ProxyScaleSteps = 16.f;
+	
+	OFS_FrameExporter frameExporter;
+	// seeks to every timestamp & captures the frame once mpv rendered it
+	struct FrameExportState {
+		std::vector<int32_t> timesMs;
+		size_t next = 0;
+		std::string directory;
+		OFS_FrameExporter::Format format = OFS_FrameExporter::Format::Png;
+		bool seeking = false;
+		bool seekDone = false;
+		bool rendered = false;
+		bool active = false;
+	} frameExport;
+	// a screenshot taken during proxy playback waits for a full resolution frame
+	std::string pendingScreenshot;
 
 	std::unique_ptr<class VrShader> vr_shader;
 	ImGuiViewport* player_viewport;
@@ -83,6 +113,7 @@ private:
 		MpvFramesPerSecond,
 		MpvAbLoopA,
 		MpvAbLoopB,
+		MpvAudioPts,
 	};
 
 	enum MpvCommandIdentifier : uint64_t {
@@ -110,13 +141,27 @@ private:
 		const char* file_path = nullptr;
 	} MpvData;
 
+	// exact frame times once the background index of the video is done
+	OFS_FrameIndex frameIndex;
+	struct FrameIndexTask {
+		VideoplayerWindow* player = nullptr;
+		std::string videoPath;
+		OFS_FrameIndex index;
+	};
+	void startFrameIndexTask() noexcept;
+	void applyFrameIndexTask(FrameIndexTask* task) noexcept;
+	void seekToFrame(int64_t frame) noexcept;
+
 	char tmp_buf[32];
 
 	float base_scale_factor = 1.f;
 
 	const float zoom_multi = 0.1f;
 	
-	std::chrono::high_resolution_clock::time_point smooth_time;
+	OFS_PlaybackClock clock;
+	// the audio clock is more precise than the video position if the file has audio
+	bool hasAudioPts = false;
+	int64_t latchedTimeNs = 0;
 
 	bool videoHovered = false;
 	bool dragStarted = false;
@@ -127,7 +172,12 @@ private:
 
 	void observeProperties() noexcept;
 	void renderToTexture() noexcept;
-	void updateRenderTexture() noexcept;
+	// displays the pending target once the gpu is done with it
+	void presentRenderTarget() noexcept;
+	// recreates the render targets if the wanted resolution changed
+	bool updateRenderTexture() noexcept;
+	float renderScale() const noexcept;
+	void destroyRenderTargets() noexcept;
 	void mouse_scroll(SDL_Event& ev) noexcept;
 
 	void setup_vr_mode() noexcept;
@@ -140,9 +190,14 @@ private:
 
 	void showText(const char* text) noexcept;
 	void clearLoop() noexcept;
+
+	std::string frameFilename(const std::string& directory, double seconds, OFS_FrameExporter::Format format) noexcept;
+	void updateFrameExport() noexcept;
 public:
 	static constexpr const char* PlayerId = "Player";
 	ImDrawCallback OnRenderCallback = nullptr;
+	// optional. measures the mpv render & vr shader passes
+	OFS_GpuTimer* GpuTimer = nullptr;
 
 	struct OFS_VideoPlayerSettings {
 		ImVec2 current_vr_rotation = ImVec2(0.5f, -0.5f);
@@ -157,6 +212,9 @@ public:
 		float volume = 0.5f;
 		float playback_speed = 1.f;
 		bool LockedPosition = false;
+		// renders at the on-screen resolution while playing
+		bool proxyPlayback = false;
+		OFS_FrameExporter::Format exportFormat = OFS_FrameExporter::Format::Png;
 
 		template <class Archive>
 		inline void reflect(Archive& ar) {
@@ -171,6 +229,9 @@ public:
 			OFS_REFLECT(prev_translation, ar);
 			OFS_REFLECT(video_pos, ar);
 			OFS_REFLECT(LockedPosition, ar);
+			OFS_REFLECT(proxyPlayback, ar);
+			OFS_REFLECT(exportFormat, ar);
+			exportFormat = (OFS_FrameExporter::Format)Util::Clamp<int32_t>(exportFormat, OFS_FrameExporter::Format::Png, OFS_FrameExporter::Format::Jpg);
 		}
 	};
 
@@ -195,16 +256,25 @@ public:
 	void openVideo(const std::string& file);
 	void saveFrameToImage(const std::string& file);
 
+	// captures the frame at every timestamp without stalling the render thread
+	void exportFrames(std::vector<int32_t>&& timesMs, const std::string& directory, OFS_FrameExporter::Format format) noexcept;
+	void cancelFrameExport() noexcept;
+	inline bool isExportingFrames() const noexcept { return frameExport.active || frameExporter.Busy(); }
+	inline size_t exportedFrameCount() const noexcept { return frameExport.next; }
+	inline size_t totalExportFrameCount() const noexcept { return frameExport.timesMs.size(); }
+
 	inline double getCurrentPositionMsInterp() const noexcept { return getCurrentPositionSecondsInterp() * 1000.0; }
 	inline double getCurrentPositionSecondsInterp() const noexcept {
 		if (MpvData.paused) {
 			return getCurrentPositionSeconds();
 		}
 		else {
-			std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - smooth_time;
-			return getCurrentPositionSeconds() + (duration.count() * MpvData.current_speed);
+			return clock.Position(latchedTimeNs);
 		}
 	}
+	// the main thread sees the same interpolated position for the whole frame
+	inline void latchClock() noexcept { latchedTimeNs = OFS_PlaybackClock::Now(); }
+	inline const OFS_PlaybackClock& getClock() const noexcept { return clock; }
 
 	inline double getCurrentPositionMs() const noexcept { return getCurrentPositionSeconds() * 1000.0; }
 	inline double getCurrentPositionSeconds() const noexcept { return MpvData.percent_pos * MpvData.duration; }
@@ -236,10 +306,16 @@ public:
 	inline double getFrameTimeMs() const noexcept { return MpvData.average_frame_time * 1000.0; }
 	inline double getSpeed() const noexcept { return MpvData.current_speed; }
 	inline double getDuration() const noexcept { return MpvData.duration; }
-	inline int64_t getTotalNumFrames() const  noexcept { return MpvData.total_num_frames; }
+	inline int64_t getTotalNumFrames() const  noexcept { return frameIndex.Empty() ? MpvData.total_num_frames : frameIndex.FrameCount(); }
 	inline bool isPaused() const noexcept { return MpvData.paused; };
 	inline double getPosition() const noexcept { return MpvData.percent_pos; }
-	inline int64_t getCurrentFrameEstimate() const noexcept { return MpvData.percent_pos * MpvData.total_num_frames; }
+	inline int64_t getCurrentFrameEstimate() const noexcept {
+		return frameIndex.Empty()
+			? MpvData.percent_pos * MpvData.total_num_frames
+			: frameIndex.FrameAt(getCurrentPositionSeconds());
+	}
+	// empty until the video was indexed
+	inline const OFS_FrameIndex& getFrameIndex() const noexcept { return frameIndex; }
 	inline double getFps() const noexcept { return MpvData.fps; }
 	inline bool isLoaded() const noexcept { return MpvData.video_loaded; }
 	
@@ -2,17 +2,107 @@
 #include "OFS_Util.h"
 
 #include "SDL_timer.h"
+#include "SDL_thread.h"
+#include "glad/glad.h"
 
 static char tmp_buf[2][32];
 
 void OFS_VideoplayerControls::VideoLoaded(SDL_Event& ev) noexcept
 {
+    thumbnails.Clear();
+    thumbnailGeneration++;
+    thumbnailsRequested = false;
+    thumbnailsFailed = false;
+    videoPath.clear();
     if (ev.user.data1 != nullptr)
     {
-        videoPreview->previewVideo((const char*)ev.user.data1, 0.f);
+        videoPath = (const char*)ev.user.data1;
     }
 }
 
+void OFS_VideoplayerControls::startThumbnailTask() noexcept
+{
+    thumbnailsRequested = true;
+    auto generateThumbnails = [](void* user) -> int {
+        auto task = (ThumbnailTask*)user;
+        // rows get uploaded one by one so that only one of them is uncompressed at a time
+        auto rowDone = [task](const OFS_Thumbnails::Strip& strip, int32_t row, const uint8_t* pixels) {
+            auto rowTask = new ThumbnailRow();
+            rowTask->controls = task->controls;
+            rowTask->generation = task->generation;
+            rowTask->row = row;
+            rowTask->expectedRows = task->expectedRows;
+            rowTask->intervalMs = strip.intervalMs;
+            rowTask->pixels.assign(pixels, pixels + OFS_Thumbnails::RowBytes);
+            EventSystem::SingleShot([](void* ctx) {
+                auto rowTask = (ThumbnailRow*)ctx;
+                rowTask->controls->applyThumbnailRow(rowTask);
+            }, rowTask);
+        };
+        OFS_MediaCacheKey key;
+        bool hasKey = OFS_MediaCacheKey::FromMedia(task->videoPath, key);
+        if (hasKey && task->strip.LoadCache(key)) {
+            LOGF_INFO("Loaded cached thumbnails for \"%s\"", task->videoPath.c_str());
+            std::vector<uint8_t> pixels(OFS_Thumbnails::RowBytes);
+            task->expectedRows = task->strip.Rows();
+            for (int32_t row = 0; row < task->strip.Rows(); row++) {
+                if (!task->strip.DecodeRow(row, pixels.data())) {
+                    // only the rows before it got uploaded
+                    task->strip.count = row * OFS_Thumbnails::AtlasColumns;
+                    break;
+                }
+                rowDone(task->strip, row, pixels.data());
+            }
+        }
+        else {
+            auto ffmpegPath = Util::FfmpegPath();
+            if (OFS_Thumbnails::Strip::Generate(ffmpegPath.u8string(), task->videoPath, task->intervalMs, task->strip, rowDone) && hasKey) {
+                // the video was closed or reopened while generating, its new task writes the cache
+                if (task->generation == task->controls->thumbnailGeneration) {
+                    task->strip.SaveCache(key);
+                }
+            }
+        }
+        EventSystem::SingleShot([](void* ctx) {
+            auto task = (ThumbnailTask*)ctx;
+            task->controls->applyThumbnailTask(task);
+        }, task);
+        return 0;
+    };
+    auto task = new ThumbnailTask();
+    task->controls = this;
+    task->videoPath = videoPath;
+    task->generation = thumbnailGeneration;
+    task->intervalMs = OFS_Thumbnails::Strip::IntervalFor(player->getDuration() * 1000.f);
+    task->expectedRows = OFS_Thumbnails::Strip::RowsFor(player->getDuration() * 1000.f, task->intervalMs);
+    auto handle = SDL_CreateThread(generateThumbnails, "OFS_GenThumbnails", task);
+    SDL_DetachThread(handle);
+}
+
+void OFS_VideoplayerControls::applyThumbnailTask(ThumbnailTask* task) noexcept
+{
+    // the video might have changed or been reopened in the meantime
+    if (task->generation == thumbnailGeneration) {
+        // rows which made it before a failure stay usable
+        // they were queued before this task so they're uploaded by now
+        if (task->strip.count > 0 && thumbnails.Ready()) {
+            thumbnails.Finish(task->strip.count);
+        }
+        else {
+            thumbnailsFailed = true;
+        }
+    }
+    delete task;
+}
+
+void OFS_VideoplayerControls::applyThumbnailRow(ThumbnailRow* row) noexcept
+{
+    if (row->generation == thumbnailGeneration) {
+        thumbnails.UploadRow(row->pixels.data(), row->row, row->expectedRows, row->intervalMs);
+    }
+    delete row;
+}
+
 OFS_VideoplayerControls::OFS_VideoplayerControls() noexcept
 {
     TimelineGradient.addMark(0.f, IM_COL32_BLACK);
@@ -20,10 +110,49 @@ OFS_VideoplayerControls::OFS_VideoplayerControls() noexcept
     TimelineGradient.refreshCache();
 }
 
+void OFS_VideoplayerControls::Destroy() noexcept
+{
+    thumbnails.Clear();
+    if (heatmapTexture != 0) {
+        glDeleteTextures(1, &heatmapTexture);
+        heatmapTexture = 0;
+    }
+}
+
+void OFS_VideoplayerControls::updateHeatmapTexture(int32_t width) noexcept
+{
+    width = std::max(width, 1);
+    if (!heatmapDirty && width == heatmapWidth) return;
+
+    heatmapPixels.resize(width);
+    TimelineGradient.rasterize(heatmapPixels.data(), width);
+
+    if (heatmapTexture == 0) {
+        glGenTextures(1, &heatmapTexture);
+        glBindTexture(GL_TEXTURE_2D, heatmapTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    else {
+        glBindTexture(GL_TEXTURE_2D, heatmapTexture);
+    }
+
+    // a single row, ImGui only draws 2D textures
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    if (width != heatmapWidth) {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, heatmapPixels.data());
+    }
+    else {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, 1, GL_RGBA, GL_UNSIGNED_BYTE, heatmapPixels.data());
+    }
+    heatmapWidth = width;
+    heatmapDirty = false;
+}
+
 void OFS_VideoplayerControls::setup() noexcept
 {
-    videoPreview = std::make_unique<VideoPreview>();
-    videoPreview->setup(false);
     EventSystem::ev().Subscribe(VideoEvents::MpvVideoLoaded, EVENT_SYSTEM_BIND(this, &OFS_VideoplayerControls::VideoLoaded));
 }
 
@@ -52,6 +181,11 @@ bool OFS_VideoplayerControls::DrawTimelineWidget(const char* label, float* posit
 
     const bool item_hovered = ImGui::IsItemHovered();
 
+    // the duration is only known after the video started playing
+    if (!thumbnailsRequested && !videoPath.empty() && player->getDuration() > 0.f) {
+        startThumbnailTask();
+    }
+
     const float current_pos_x = frame_bb.Min.x + frame_bb.GetWidth() * (*position);
     const float offset_progress_h = h / 5.f;
     const float offset_progress_w = current_pos_x - frame_bb.Min.x;
@@ -66,7 +200,8 @@ bool OFS_VideoplayerControls::DrawTimelineWidget(const char* label, float* posit
     constexpr float timeline_pos_cursor_w = 5.f;
     draw_list->AddLine(p1 + ImVec2(0.f, h / 3.f), p2 + ImVec2(0.f, h / 3.f), IM_COL32(255, 0, 0, 255), timeline_pos_cursor_w / 2.f);
 
-    ImGradient::DrawGradientBar(&TimelineGradient, frame_bb.Min, frame_bb.GetWidth(), frame_bb.GetHeight());
+    updateHeatmapTexture((int32_t)(frame_bb.GetWidth() * ImGui::GetIO().DisplayFramebufferScale.x));
+    ImGradient::DrawGradientBar((ImTextureID)(intptr_t)heatmapTexture, frame_bb.Min, frame_bb.GetWidth(), frame_bb.GetHeight());
 
     const ImColor timeline_cursor_back = IM_COL32(255, 255, 255, 255);
     const ImColor timeline_cursor_front = IM_COL32(0, 0, 0, 255);
@@ -79,14 +214,21 @@ bool OFS_VideoplayerControls::DrawTimelineWidget(const char* label, float* posit
 
         ImGui::BeginTooltipEx(ImGuiWindowFlags_None, ImGuiTooltipFlags_None);
         {
-            if (SDL_GetTicks() - lastPreviewUpdate >= PreviewUpdateMs)
-            {
-                videoPreview->setPosition(rel_timeline_pos);
-                lastPreviewUpdate = SDL_GetTicks();
-            }
             const ImVec2 ImageDim = ImVec2(ImGui::GetFontSize()*7.f * (16.f / 9.f), ImGui::GetFontSize() * 7.f);
-            ImGui::Image((void*)(intptr_t)videoPreview->render_texture, ImageDim);
             float time_seconds = player->getDuration() * rel_timeline_pos;
+            ImVec2 uv0, uv1;
+            if (thumbnails.Ready() && thumbnails.Lookup(time_seconds * 1000.f, &uv0, &uv1))
+            {
+                ImGui::Image(thumbnails.Texture(), ImageDim, uv0, uv1);
+            }
+            else if (thumbnailsFailed)
+            {
+                ImGui::TextDisabled("No preview available");
+            }
+            else
+            {
+                ImGui::TextDisabled("Generating preview...");
+            }
             float time_delta = time_seconds - player->getCurrentPositionSecondsInterp();
             Util::FormatTime(tmp_buf[0], sizeof(tmp_buf[0]), time_seconds, false);
             Util::FormatTime(tmp_buf[1], sizeof(tmp_buf[1]), (time_delta > 0) ? time_delta : -time_delta, false);
@@ -2,9 +2,12 @@
 
 #include "OFS_Videoplayer.h"
 #include "GradientBar.h"
-#include "OFS_Videopreview.h"
+#include "OFS_Thumbnails.h"
 
 #include <functional>
+#include <vector>
+#include <string>
+#include <atomic>
 
 // ImDrawList* draw_list, const ImRect& frame_bb, bool item_hovered
 using TimelineCustomDrawFunc = std::function<void(ImDrawList*, const ImRect&, bool)>;
@@ -19,21 +22,61 @@ private:
 	bool mute = false;
 	bool hasSeeked = false;
 	bool dragging = false;
-	
-	static constexpr int32_t PreviewUpdateMs = 1000;
-	uint32_t lastPreviewUpdate = 0;
+
+	// TimelineGradient rasterized at display resolution
+	uint32_t heatmapTexture = 0;
+	int32_t heatmapWidth = 0;
+	bool heatmapDirty = true;
+	std::vector<uint32_t> heatmapPixels;
+
+	// hover previews are looked up in the thumbnail atlas
+	// it fills in row by row while ffmpeg is still generating it
+	OFS_Thumbnails thumbnails;
+	std::string videoPath;
+	// bumped for every loaded video, tasks of an older one get ignored
+	// read by the tasks before they write the cache
+	std::atomic<uint32_t> thumbnailGeneration = 0;
+	bool thumbnailsRequested = false;
+	// ffmpeg is missing or couldn't read the video
+	bool thumbnailsFailed = false;
+
+	// background work on the thumbnails of videoPath
+	// the rows get uploaded on the main thread as they arrive
+	struct ThumbnailTask {
+		OFS_VideoplayerControls* controls = nullptr;
+		std::string videoPath;
+		uint32_t generation = 0;
+		int32_t intervalMs = 0;
+		int32_t expectedRows = 0;
+		OFS_Thumbnails::Strip strip;
+	};
+	// a copy of a finished row while the task is still running
+	struct ThumbnailRow {
+		OFS_VideoplayerControls* controls = nullptr;
+		uint32_t generation = 0;
+		int32_t row = 0;
+		int32_t expectedRows = 0;
+		int32_t intervalMs = 0;
+		std::vector<uint8_t> pixels;
+	};
+	void startThumbnailTask() noexcept;
+	void applyThumbnailTask(ThumbnailTask* task) noexcept;
+	void applyThumbnailRow(ThumbnailRow* row) noexcept;
 
 	void VideoLoaded(SDL_Event& ev) noexcept;
+	void updateHeatmapTexture(int32_t width) noexcept;
 public:
 	static constexpr const char* PlayerControlId = "Controls";
 	static constexpr const char* PlayerTimeId = "Time";
 	VideoplayerWindow* player = nullptr;
 	ImGradient TimelineGradient;
-	std::unique_ptr<VideoPreview> videoPreview;
 
 	OFS_VideoplayerControls() noexcept;
 	void setup() noexcept;
-	inline void Destroy() noexcept { videoPreview.reset(); }
+	void Destroy() noexcept;
+
+	// has to be called after TimelineGradient was modified
+	inline void TimelineGradientChanged() noexcept { heatmapDirty = true; }
 
 	bool DrawTimelineWidget(const char* label, float* position, TimelineCustomDrawFunc&& customDraw) noexcept;
 
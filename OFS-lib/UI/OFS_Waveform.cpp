@@ -1,149 +1,613 @@
 #include "OFS_Waveform.h"
 #include "OFS_Util.h"
 
-//#define MINIMP3_ONLY_SIMD
-//#define MINIMP3_NO_SIMD
-#define MINIMP3_ONLY_MP3
-//#define MINIMP3_FLOAT_OUTPUT
-#define MINIMP3_IMPLEMENTATION
-#include "minimp3.h"
-#include "minimp3_ex.h"
-
-bool OFS_Waveform::LoadMP3(const std::string& path) noexcept
-{
-	static mp3dec_t mp3d;
-	mp3dec_file_info_t info;
+#include "reproc++/reproc.hpp"
+#include "reproc++/drain.hpp"
+
+#include "SDL_thread.h"
+#include "SDL_mutex.h"
+#include "SDL_cpuinfo.h"
+
+#include <array>
+#include <deque>
+#include <cmath>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define OFS_WAVEFORM_SSE2
+#include <emmintrin.h>
+#endif
+
+// ffmpeg resamples to this rate
+// the high band doesn't need more than ~11kHz for visualization
+constexpr int32_t PcmSampleRate = 22050;
+// ~1225 lines per second
+constexpr int32_t SamplesPerLine = 18;
+
+// band crossovers in Hz
+constexpr float LowBandCutoff = 250.f;
+constexpr float HighBandCutoff = 4000.f;
+// time constant of the rms envelope
+constexpr float EnvelopeSeconds = 0.01f;
+
+// the pcm stream is split into chunks which get analyzed in parallel
+constexpr int32_t LinesPerChunk = 16384;
+constexpr int32_t ChunkSamples = LinesPerChunk * SamplesPerLine;
+// each chunk runs the filters over the end of the previous chunk first
+// so that the filter state has settled when the first line gets written
+constexpr int32_t PrerollSamples = 4096;
+
+constexpr float Pi = 3.14159265358979f;
+
+namespace {
+	// https://www.w3.org/TR/audio-eq-cookbook/
+	struct Biquad {
+		float b0 = 0.f, b1 = 0.f, b2 = 0.f, a1 = 0.f, a2 = 0.f;
+
+		static Biquad Make(float b0, float b1, float b2, float a0, float a1, float a2) noexcept
+		{
+			Biquad q;
+			q.b0 = b0 / a0; q.b1 = b1 / a0; q.b2 = b2 / a0;
+			q.a1 = a1 / a0; q.a2 = a2 / a0;
+			return q;
+		}
+
+		static Biquad LowPass(float freq, float Q) noexcept
+		{
+			float w0 = 2.f * Pi * freq / PcmSampleRate;
+			float alpha = std::sin(w0) / (2.f * Q);
+			float cosw0 = std::cos(w0);
+			return Make((1.f - cosw0) / 2.f, 1.f - cosw0, (1.f - cosw0) / 2.f,
+				1.f + alpha, -2.f * cosw0, 1.f - alpha);
+		}
+
+		static Biquad HighPass(float freq, float Q) noexcept
+		{
+			float w0 = 2.f * Pi * freq / PcmSampleRate;
+			float alpha = std::sin(w0) / (2.f * Q);
+			float cosw0 = std::cos(w0);
+			return Make((1.f + cosw0) / 2.f, -(1.f + cosw0), (1.f + cosw0) / 2.f,
+				1.f + alpha, -2.f * cosw0, 1.f - alpha);
+		}
+
+		// constant 0 dB peak gain between lowFreq & highFreq
+		static Biquad BandPass(float lowFreq, float highFreq) noexcept
+		{
+			float center = std::sqrt(lowFreq * highFreq);
+			float bandwidth = std::log2(highFreq / lowFreq);
+			float w0 = 2.f * Pi * center / PcmSampleRate;
+			float sinw0 = std::sin(w0);
+			float alpha = sinw0 * std::sinh(std::log(2.f) / 2.f * bandwidth * w0 / sinw0);
+			float cosw0 = std::cos(w0);
+			return Make(alpha, 0.f, -alpha,
+				1.f + alpha, -2.f * cosw0, 1.f - alpha);
+		}
+	};
+
+	inline void BandCoefficients(Biquad& low, Biquad& mid, Biquad& high) noexcept
+	{
+		constexpr float ButterworthQ = 0.70710678f;
+		low = Biquad::LowPass(LowBandCutoff, ButterworthQ);
+		mid = Biquad::BandPass(LowBandCutoff, HighBandCutoff);
+		high = Biquad::HighPass(HighBandCutoff, ButterworthQ);
+	}
+
+	inline float EnvelopeAlpha() noexcept
+	{
+		return 1.f - std::exp(-1.f / (EnvelopeSeconds * PcmSampleRate));
+	}
+
+#ifdef OFS_WAVEFORM_SSE2
+	// runs the low, mid & high filter side by side in the lanes of a sse register
+	// lane 0 = low, lane 1 = mid, lane 2 = high, lane 3 = unused
+	struct BandSplitter {
+		__m128 b0, b1, b2, a1, a2;
+		__m128 x1, x2, y1, y2;
+		__m128 envelope;
+		__m128 envelopeAlpha;
+		__m128 peak;
+
+		BandSplitter() noexcept
+		{
+			Biquad low, mid, high;
+			BandCoefficients(low, mid, high);
+			// _mm_set_ps takes the lanes in reverse order
+			b0 = _mm_set_ps(0.f, high.b0, mid.b0, low.b0);
+			b1 = _mm_set_ps(0.f, high.b1, mid.b1, low.b1);
+			b2 = _mm_set_ps(0.f, high.b2, mid.b2, low.b2);
+			a1 = _mm_set_ps(0.f, high.a1, mid.a1, low.a1);
+			a2 = _mm_set_ps(0.f, high.a2, mid.a2, low.a2);
+			x1 = x2 = y1 = y2 = envelope = peak = _mm_setzero_ps();
+			envelopeAlpha = _mm_set1_ps(EnvelopeAlpha());
+		}
+
+		inline void process(float sample) noexcept
+		{
+			__m128 x = _mm_set1_ps(sample);
+			// direct form 1
+			__m128 y = _mm_mul_ps(b0, x);
+			y = _mm_add_ps(y, _mm_mul_ps(b1, x1));
+			y = _mm_add_ps(y, _mm_mul_ps(b2, x2));
+			y = _mm_sub_ps(y, _mm_mul_ps(a1, y1));
+			y = _mm_sub_ps(y, _mm_mul_ps(a2, y2));
+			x2 = x1; x1 = x;
+			y2 = y1; y1 = y;
 
-	SamplesLow.clear();
-	SamplesMid.clear();
-	SamplesHigh.clear();
+			// exponential moving average of the squared signal
+			__m128 squared = _mm_mul_ps(y, y);
+			envelope = _mm_add_ps(envelope, _mm_mul_ps(envelopeAlpha, _mm_sub_ps(squared, envelope)));
 
-	mp3dec_init(&mp3d);
+			const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+			peak = _mm_max_ps(peak, _mm_and_ps(y, absMask));
+		}
 
-	struct Mp3Context {
-		OFS_Waveform* wave = nullptr;
-		float lowPeak = 0.f;
-		float midPeak = 0.f;
-		float highPeak = 0.f;
+		// writes the rms & peak of each band since the last call
+		inline void finishLine(float* rms, float* peakOut) noexcept
+		{
+			_mm_storeu_ps(rms, _mm_sqrt_ps(envelope));
+			_mm_storeu_ps(peakOut, peak);
+			peak = _mm_setzero_ps();
+		}
 	};
-	Mp3Context ctx;
-	ctx.wave = this;
-	mp3dec_iterate(path.c_str(),
-		[](void* user_data, const uint8_t* frame,
-			int frame_size, int free_format_bytes,
-			size_t buf_size, uint64_t offset,
-			mp3dec_frame_info_t* info) -> int 
+#else
+	// same as the sse version one band after another
+	struct BandSplitter {
+		static constexpr int32_t Bands = 3;
+		Biquad filters[Bands];
+		float x1 = 0.f, x2 = 0.f;
+		float y1[Bands] = {}, y2[Bands] = {};
+		float envelope[Bands] = {};
+		float envelopeAlpha;
+		float peak[Bands] = {};
+
+		BandSplitter() noexcept
+		{
+			BandCoefficients(filters[0], filters[1], filters[2]);
+			envelopeAlpha = EnvelopeAlpha();
+		}
+
+		inline void process(float x) noexcept
+		{
+			for (int32_t band = 0; band < Bands; band++) {
+				auto& f = filters[band];
+				float y = f.b0 * x + f.b1 * x1 + f.b2 * x2 - f.a1 * y1[band] - f.a2 * y2[band];
+				y2[band] = y1[band]; y1[band] = y;
+				envelope[band] += envelopeAlpha * (y * y - envelope[band]);
+				peak[band] = std::max(peak[band], std::abs(y));
+			}
+			x2 = x1; x1 = x;
+		}
+
+		inline void finishLine(float* rms, float* peakOut) noexcept
 		{
-			constexpr float LowRangeMin = 0.f; constexpr float LowRangeMax = 500.f;
-			constexpr float MidRangeMin = 501.f; constexpr float MidRangeMax = 6000.f;
-			constexpr float HighRangeMin = 6001.f; constexpr float HighRangeMax = 20000.f;
-			Mp3Context* ctx = (Mp3Context*)user_data;
-			mp3d_sample_t pcm[MINIMP3_MAX_SAMPLES_PER_FRAME];
-			auto samples = mp3dec_decode_frame(&mp3d, frame, buf_size, pcm, info);
-
-			FUN_ASSERT(samples <= 1152, "got more samples than expected");
-			// 1152 is the sample count per frame
-			constexpr int SamplesPerLine = 1152/32;
-
-			//auto floatToInt = [](float pcmVal) -> int32_t
-			//{
-			//	pcmVal = pcmVal * 32768.f;
-			//	//if (pcmVal > 32767) pcmVal = 32767;
-			//	//if (pcmVal < -32768) pcmVal = -32768;
-			//	return pcmVal;
-			//};
-
-			auto shortToFloat = [](int16_t pcmVal) -> float {
-				return (1.0f/32768.0f) * pcmVal;
-			};
-
-			for(int sampleIdx=0; sampleIdx < samples; sampleIdx += SamplesPerLine)
-			{
-				//float lowPeak = 0.f, midPeak = 0.f, highPeak = 0.f;
-				//int16_t lowPeak = 0, midPeak = 0, highPeak = 0;
-				for (int i = 0; i < SamplesPerLine; i++) { 
-					mp3d_sample_t sample = pcm[sampleIdx + i];
-					if (sample == 0) continue;
-					sample = std::abs(sample/2);
-
-					if (sample <= LowRangeMax) {
-						// low range
-						//lowPeak = std::max(lowPeak, sample);
-						ctx->lowPeak += sample;
-					}
-					if (sample <= MidRangeMax) {
-						// mid range
-						//midPeak = std::max(midPeak, sample);
-						ctx->midPeak += sample;
-					}
-					if (sample <= HighRangeMax) {
-						// high range
-						//highPeak = std::max(highPeak, sample);
-						ctx->highPeak += sample;
-					}
-				}
-				ctx->lowPeak /= (float)SamplesPerLine;
-				ctx->midPeak /= (float)SamplesPerLine;
-				ctx->highPeak /= (float)SamplesPerLine;
-
-				ctx->wave->SamplesLow.push_back(ctx->lowPeak);
-				ctx->wave->SamplesMid.push_back(ctx->midPeak);
-				ctx->wave->SamplesHigh.push_back(ctx->highPeak);
+			for (int32_t band = 0; band < Bands; band++) {
+				rms[band] = std::sqrt(envelope[band]);
+				peakOut[band] = peak[band];
+				peak[band] = 0.f;
 			}
+			rms[Bands] = peakOut[Bands] = 0.f;
+		}
+	};
+#endif
 
-			return 0;
-	}, &ctx);
+	struct BandLine {
+		float rms[4];
+		float peak[4];
+	};
 
-	SamplesLow.shrink_to_fit();
-	SamplesMid.shrink_to_fit();
-	SamplesHigh.shrink_to_fit();
+	struct AnalysisJob {
+		int32_t index = 0;
+		int32_t preroll = 0;
+		std::vector<int16_t> samples;
+	};
 
-	auto mapSamples = [](std::vector<float>& samples, float min, float max) noexcept
-	{
-		if (samples.size() <= 1) return;
-		if (min != 0.f || max != 1.f) {
-			for (auto& val : samples) {
-				val = Util::MapRange<float>(val, min, max, 0.f, 1.f);
+	struct AnalysisContext {
+		SDL_mutex* mutex = nullptr;
+		SDL_cond* jobAvailable = nullptr;
+		// limits the amount of chunks held in memory
+		SDL_sem* freeSlots = nullptr;
+
+		std::deque<AnalysisJob> jobs;
+		std::vector<std::vector<BandLine>> results;
+		bool done = false;
+
+		// the chunk currently being filled by the reader
+		AnalysisJob current;
+		int32_t chunkCount = 0;
+
+		uint8_t oddByte = 0;
+		bool hasOddByte = false;
+
+		void submit() noexcept
+		{
+			SDL_SemWait(freeSlots);
+			current.index = chunkCount++;
+			AnalysisJob next;
+			// carry the end of this chunk over as preroll of the next one
+			size_t preroll = std::min<size_t>(PrerollSamples, current.samples.size());
+			next.preroll = preroll;
+			next.samples.reserve(ChunkSamples + PrerollSamples);
+			next.samples.insert(next.samples.end(), current.samples.end() - preroll, current.samples.end());
+
+			SDL_LockMutex(mutex);
+			results.resize(chunkCount);
+			jobs.emplace_back(std::move(current));
+			SDL_CondSignal(jobAvailable);
+			SDL_UnlockMutex(mutex);
+			current = std::move(next);
+		}
+
+		inline void pushSample(int16_t sample) noexcept
+		{
+			current.samples.push_back(sample);
+			if (current.samples.size() - current.preroll == ChunkSamples) submit();
+		}
+
+		void feed(const uint8_t* buffer, size_t size) noexcept
+		{
+			if (size == 0) return;
+			if (hasOddByte) {
+				uint8_t tmp[2] = { oddByte, buffer[0] };
+				pushSample(*(int16_t*)tmp);
+				buffer++; size--;
+				hasOddByte = false;
+			}
+			// s16le is native on all the platforms we care about
+			const int16_t* samples = (const int16_t*)buffer;
+			const size_t sampleCount = size / sizeof(int16_t);
+			for (size_t i = 0; i < sampleCount; i++) {
+				pushSample(samples[i]);
+			}
+			if (size % sizeof(int16_t) != 0) {
+				oddByte = buffer[size - 1];
+				hasOddByte = true;
 			}
 		}
+
+		void finish() noexcept
+		{
+			if (current.samples.size() > current.preroll) {
+				submit();
+			}
+			SDL_LockMutex(mutex);
+			done = true;
+			SDL_CondBroadcast(jobAvailable);
+			SDL_UnlockMutex(mutex);
+		}
 	};
-	
-	auto [lowMin, lowMax] = std::minmax_element(SamplesLow.begin(), SamplesLow.end());
-	LowMax = *lowMax;
-	auto [midMin, midMax] = std::minmax_element(SamplesMid.begin(), SamplesMid.end());
-	MidMax = *midMax;
-
-	auto [highMin, highMax] = std::minmax_element(SamplesHigh.begin(), SamplesHigh.end());
-	float min = std::min(*lowMin, *midMin);	min = std::min(min, *highMin);
-	float max = std::max(*lowMax, *midMax);	max = std::max(max, *highMax);
-	mapSamples(SamplesLow, min, max);
-	mapSamples(SamplesMid, min, max);
-	mapSamples(SamplesHigh, min, max);
-
-	LowMax = Util::MapRange(LowMax, min, max, 0.f, 1.f);
-	MidMax = Util::MapRange(MidMax, min, max, 0.f, 1.f);
 
-	return true;
+	void AnalyzeChunk(const AnalysisJob& job, std::vector<BandLine>& lines) noexcept
+	{
+		constexpr float shortToFloat = 1.f / 32768.f;
+		BandSplitter splitter;
+		for (int32_t i = 0; i < job.preroll; i++) {
+			splitter.process(job.samples[i] * shortToFloat);
+		}
+		// the preroll only settles the filters
+		BandLine preroll;
+
+		splitter.finishLine(preroll.rms, preroll.peak);
+		const int32_t sampleCount = job.samples.size();
+		lines.reserve((sampleCount - job.preroll) / SamplesPerLine + 1);
+		for (int32_t lineStart = job.preroll; lineStart < sampleCount; lineStart += SamplesPerLine) {
+			const int32_t lineEnd = std::min(lineStart + SamplesPerLine, sampleCount);
+			for (int32_t i = lineStart; i < lineEnd; i++) {
+				splitter.process(job.samples[i] * shortToFloat);
+			}
+			auto& line = lines.emplace_back();
+			splitter.finishLine(line.rms, line.peak);
+		}
+	}
+
+	int AnalysisWorker(void* user) noexcept
+	{
+		auto& ctx = *(AnalysisContext*)user;
+		for (;;) {
+			SDL_LockMutex(ctx.mutex);
+			while (ctx.jobs.empty() && !ctx.done) {
+				SDL_CondWait(ctx.jobAvailable, ctx.mutex);
+			}
+			if (ctx.jobs.empty()) {
+				SDL_UnlockMutex(ctx.mutex);
+				break;
+			}
+			AnalysisJob job = std::move(ctx.jobs.front());
+			ctx.jobs.pop_front();
+			SDL_UnlockMutex(ctx.mutex);
+
+			std::vector<BandLine> lines;
+			AnalyzeChunk(job, lines);
+
+			SDL_LockMutex(ctx.mutex);
+			ctx.results[job.index] = std::move(lines);
+			SDL_UnlockMutex(ctx.mutex);
+			SDL_SemPost(ctx.freeSlots);
+		}
+		return 0;
+	}
 }
 
-bool OFS_Waveform::GenerateMP3(const std::string& ffmpegPath, const std::string& videoPath, const std::string& output) noexcept
+bool OFS_Waveform::Generate(const std::string& ffmpegPath, const std::string& videoPath, OFS_Waveform& output) noexcept
 {
-	generating = true;
-	reproc::options options;
-	options.redirect.parent = true;
-	std::array<const char*, 10> args =
+	output.Clear();
+
+	char sampleRate[16];
+	stbsp_snprintf(sampleRate, sizeof(sampleRate), "%d", PcmSampleRate);
+	std::array<const char*, 14> args =
 	{
 		ffmpegPath.c_str(),
-		"-y",
+		"-v", "error",
 		"-i", videoPath.c_str(),
-		"-b:a", "320k",
+		"-vn",
 		"-ac", "1",
-		output.c_str(),
+		"-ar", sampleRate,
+		"-f", "s16le",
+		"-",
 		nullptr
 	};
-	auto[status, ec] = reproc::run(args.data(), options);
 
-	LOGF_WARN("OFS_Waveform::GenerateMP3: %s", ec.message().c_str());
-	generating = false;
-	return status == 0;
+	reproc::options options;
+	options.redirect.out.type = reproc::redirect::pipe;
+	options.redirect.err.type = reproc::redirect::parent;
+
+	reproc::process ffmpeg;
+	std::error_code ec = ffmpeg.start(args.data(), options);
+	if (ec) {
+		LOGF_ERROR("OFS_Waveform::Generate: failed to start ffmpeg. %s", ec.message().c_str());
+		return false;
+	}
+
+	// ffmpeg is decoding on another core already
+	const int32_t workerCount = Util::Clamp(SDL_GetCPUCount() - 1, 1, 8);
+	AnalysisContext ctx;
+	ctx.mutex = SDL_CreateMutex();
+	ctx.jobAvailable = SDL_CreateCond();
+	ctx.freeSlots = SDL_CreateSemaphore(workerCount * 2);
+	ctx.current.samples.reserve(ChunkSamples + PrerollSamples);
+
+	std::vector<SDL_Thread*> workers;
+	for (int32_t i = 0; i < workerCount; i++) {
+		workers.emplace_back(SDL_CreateThread(AnalysisWorker, "OFS_WaveformWorker", &ctx));
+	}
+
+	auto pcmSink = [&ctx](reproc::stream stream, const uint8_t* buffer, size_t size) -> std::error_code {
+		ctx.feed(buffer, size);
+		return {};
+	};
+	ec = reproc::drain(ffmpeg, pcmSink, reproc::sink::null);
+	if (ec) {
+		LOGF_ERROR("OFS_Waveform::Generate: %s", ec.message().c_str());
+	}
+	ctx.finish();
+	for (auto worker : workers) {
+		SDL_WaitThread(worker, nullptr);
+	}
+	SDL_DestroySemaphore(ctx.freeSlots);
+	SDL_DestroyCond(ctx.jobAvailable);
+	SDL_DestroyMutex(ctx.mutex);
+
+	int status = 0;
+	std::tie(status, ec) = ffmpeg.wait(reproc::infinite);
+	size_t lineCount = 0;
+	for (auto& chunk : ctx.results) { lineCount += chunk.size(); }
+	if (ec || status != 0 || lineCount == 0) {
+		LOGF_ERROR("OFS_Waveform::Generate: ffmpeg failed. status: %d %s", status, ec.message().c_str());
+		return false;
+	}
+
+	// fill the storage in cache layout
+	const size_t bandFloats = BandFloatCount(lineCount);
+	output.storage.resize(bandFloats * BandCount);
+	std::array<float, BandCount> maxRms{};
+	std::array<float, BandCount> maxPeak{};
+	for (int band = 0; band < BandCount; band++) {
+		float* bandRms = output.storage.data() + band * bandFloats;
+		float* bandPeaks = bandRms + lineCount;
+		size_t lineIdx = 0;
+		for (auto& chunk : ctx.results) {
+			for (auto& line : chunk) {
+				bandRms[lineIdx] = line.rms[band];
+				bandPeaks[lineIdx] = line.peak[band];
+				maxRms[band] = std::max(maxRms[band], line.rms[band]);
+				maxPeak[band] = std::max(maxPeak[band], line.peak[band]);
+				lineIdx++;
+			}
+		}
+
+		// every band gets normalized on it's own
+		// otherwise the low band dominates everything
+		if (maxRms[band] > 0.f) {
+			const float scale = 1.f / maxRms[band];
+			for (size_t i = 0; i < lineCount; i++) bandRms[i] *= scale;
+		}
+		if (maxPeak[band] > 0.f) {
+			const float scale = 1.f / maxPeak[band];
+			for (size_t i = 0; i < lineCount; i++) bandPeaks[i] *= scale;
+		}
+
+		// mip levels of the rms envelope
+		if (lineCount < 2) continue;
+		MinMax* level = (MinMax*)(bandPeaks + lineCount);
+		size_t levelSize = (lineCount + 1) / 2;
+		for (size_t i = 0; i < levelSize; i++) {
+			float a = bandRms[i * 2];
+			float b = i * 2 + 1 < lineCount ? bandRms[i * 2 + 1] : a;
+			level[i] = { std::min(a, b), std::max(a, b) };
+		}
+		while (levelSize > 1) {
+			const MinMax* prev = level;
+			const size_t prevSize = levelSize;
+			level += levelSize;
+			levelSize = (prevSize + 1) / 2;
+			for (size_t i = 0; i < levelSize; i++) {
+				MinMax a = prev[i * 2];
+				MinMax b = i * 2 + 1 < prevSize ? prev[i * 2 + 1] : a;
+				level[i] = { std::min(a.min, b.min), std::max(a.max, b.max) };
+			}
+		}
+	}
+	output.bindViews(output.storage.data(), lineCount);
+	return true;
+}
+
+size_t OFS_Waveform::BandFloatCount(size_t lineCount) noexcept
+{
+	// rms + peaks
+	size_t count = lineCount * 2;
+	if (lineCount >= 2) {
+		size_t levelSize = lineCount;
+		do {
+			levelSize = (levelSize + 1) / 2;
+			count += levelSize * (sizeof(MinMax) / sizeof(float));
+		} while (levelSize > 1);
+	}
+	return count;
+}
+
+void OFS_Waveform::bindViews(const float* data, size_t lines) noexcept
+{
+	static_assert(sizeof(MinMax) == 2 * sizeof(float));
+	lineCount = lines;
+	const size_t bandFloats = BandFloatCount(lines);
+	for (int band = 0; band < BandCount; band++) {
+		const float* bandData = data + band * bandFloats;
+		rms[band] = bandData;
+		peaks[band] = bandData + lines;
+
+		auto& lod = lods[band];
+		lod.samples = rms[band];
+		lod.sampleCount = lines;
+		lod.levels.clear();
+		if (lines < 2) continue;
+		const MinMax* level = (const MinMax*)(bandData + lines * 2);
+		size_t levelSize = lines;
+		do {
+			levelSize = (levelSize + 1) / 2;
+			lod.levels.emplace_back(level, levelSize);
+			level += levelSize;
+		} while (levelSize > 1);
+	}
+}
+
+OFS_Waveform::MinMax OFS_Waveform::LOD::Range(int64_t first, int64_t last) const noexcept
+{
+	MinMax result{ 0.f, 0.f };
+	if (samples == nullptr || sampleCount == 0) return result;
+	first = Util::Clamp<int64_t>(first, 0, sampleCount - 1);
+	last = Util::Clamp<int64_t>(last, first + 1, sampleCount);
+
+	const int64_t count = last - first;
+	// the coarsest level with bucketSize <= count
+	int32_t level = 0;
+	while (level < levels.size() && (int64_t(2) << level) <= count) { level++; }
+
+	if (level == 0) {
+		// at most 1 line per pixel
+		result.min = result.max = samples[first];
+		for (int64_t i = first + 1; i < last; i++) {
+			result.min = std::min(result.min, samples[i]);
+			result.max = std::max(result.max, samples[i]);
+		}
+		return result;
+	}
+
+	// since count < 2 * bucketSize this touches at most 3 buckets
+	auto [buckets, bucketCount] = levels[level - 1];
+	int64_t firstBucket = first >> level;
+	int64_t lastBucket = std::min<int64_t>((last - 1) >> level, bucketCount - 1);
+	result = buckets[firstBucket];
+	for (int64_t i = firstBucket + 1; i <= lastBucket; i++) {
+		result.min = std::min(result.min, buckets[i].min);
+		result.max = std::max(result.max, buckets[i].max);
+	}
+	return result;
+}
+
+// ===== cache =====
+
+struct WaveformCacheHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t sampleRate;
+	uint32_t samplesPerLine;
+	uint64_t lineCount;
+	uint64_t pathHash;
+	uint64_t mediaSize;
+	int64_t mediaMtime;
+	uint64_t contentHash;
+	uint8_t padding[8]; // keeps the float data 64 byte aligned
+};
+static_assert(sizeof(WaveformCacheHeader) == 64);
+constexpr char WaveformCacheMagic[4] = { 'O', 'F', 'S', 'W' };
+constexpr uint32_t WaveformCacheVersion = 1;
+
+bool OFS_Waveform::SaveCache(const CacheKey& key) const noexcept
+{
+	if (lineCount == 0 || storage.empty()) return false;
+	auto cachePath = Util::PathFromString(key.CachePath("waveform", "ofswave"));
+	if (!Util::CreateDirectories(cachePath.parent_path())) return false;
+
+	WaveformCacheHeader header = {};
+	std::copy(std::begin(WaveformCacheMagic), std::end(WaveformCacheMagic), header.magic);
+	header.version = WaveformCacheVersion;
+	header.sampleRate = PcmSampleRate;
+	header.samplesPerLine = SamplesPerLine;
+	header.lineCount = lineCount;
+	header.pathHash = key.pathHash;
+	header.mediaSize = key.mediaSize;
+	header.mediaMtime = key.mediaMtime;
+	header.contentHash = key.contentHash;
+
+	// write to a temporary file first. the old one might still be mapped
+	auto tmpPath = cachePath;
+	tmpPath.replace_extension(".tmp");
+	auto handle = SDL_RWFromFile(tmpPath.u8string().c_str(), "wb");
+	if (handle == nullptr) {
+		LOGF_ERROR("Failed to write waveform cache: %s", SDL_GetError());
+		return false;
+	}
+	bool succ = SDL_RWwrite(handle, &header, sizeof(header), 1) == 1
+		&& SDL_RWwrite(handle, storage.data(), sizeof(float), storage.size()) == storage.size();
+	SDL_RWclose(handle);
+
+	std::error_code ec;
+	if (succ) {
+		std::filesystem::rename(tmpPath, cachePath, ec);
+		if (ec) {
+			LOGF_ERROR("Failed to write waveform cache: %s", ec.message().c_str());
+			succ = false;
+		}
+	}
+	if (!succ) {
+		std::filesystem::remove(tmpPath, ec);
+	}
+	return succ;
+}
+
+bool OFS_Waveform::LoadCache(const CacheKey& key) noexcept
+{
+	Clear();
+	if (!mapping.Open(key.CachePath("waveform", "ofswave"))) return false;
+
+	if (mapping.Size() < sizeof(WaveformCacheHeader)) {
+		mapping.Close();
+		return false;
+	}
+	auto header = (const WaveformCacheHeader*)mapping.Data();
+	bool valid = std::equal(std::begin(WaveformCacheMagic), std::end(WaveformCacheMagic), header->magic)
+		&& header->version == WaveformCacheVersion
+		&& header->sampleRate == PcmSampleRate
+		&& header->samplesPerLine == SamplesPerLine
+		&& header->pathHash == key.pathHash
+		&& header->mediaSize == key.mediaSize
+		&& header->mediaMtime == key.mediaMtime
+		&& header->contentHash == key.contentHash
+		&& header->lineCount > 0
+		&& mapping.Size() == sizeof(WaveformCacheHeader) + BandFloatCount(header->lineCount) * BandCount * sizeof(float);
+	if (!valid) {
+		mapping.Close();
+		return false;
+	}
+	bindViews((const float*)(mapping.Data() + sizeof(WaveformCacheHeader)), header->lineCount);
+	return true;
 }
@@ -2,36 +2,77 @@
 
 #include <vector>
 #include <string>
+#include <array>
+#include <cstdint>
 
-#include "reproc++/run.hpp"
-
+#include "OFS_MappedFile.h"
+#include "OFS_MediaCacheKey.h"
 
 // helper class to render audio waves
+// all data lives in a single block of floats. generated waveforms own it
+// waveforms loaded from the cache map it straight from disk.
 class OFS_Waveform
 {
-	bool generating = false;
 public:
-	std::vector<float> SamplesHigh;
-	std::vector<float> SamplesMid;
-	std::vector<float> SamplesLow;
+	enum Band : int32_t {
+		Low,
+		Mid,
+		High,
+		BandCount
+	};
+
+	struct MinMax {
+		float min;
+		float max;
+	};
+
+	// min/max mipmap over the lines of a single band
+	// level 0 is the band itself every further level halves the line count
+	class LOD {
+		friend class OFS_Waveform;
+		const float* samples = nullptr;
+		size_t sampleCount = 0;
+		// levels[0] is mip level 1 (2 lines per bucket)
+		std::vector<std::pair<const MinMax*, size_t>> levels;
+	public:
+		// min/max of the lines in [first, last)
+		// uses the coarsest level whose buckets fit into the range
+		// the result is conservative since buckets may reach outside of the range
+		MinMax Range(int64_t first, int64_t last) const noexcept;
+	};
 
-	float MidMax = 0.f;
-	float LowMax = 0.f;
+	using CacheKey = OFS_MediaCacheKey;
+private:
+	std::vector<float> storage;
+	OFS_MappedFile mapping;
+	size_t lineCount = 0;
 
-	reproc::process GenerateProcess;
+	// per line rms envelope of each frequency band normalized to 0-1
+	std::array<const float*, BandCount> rms{};
+	// per line absolute peak of each frequency band normalized to 0-1
+	std::array<const float*, BandCount> peaks{};
+	std::array<LOD, BandCount> lods;
 
-	inline bool BusyGenerating() noexcept { return generating; }
+	static size_t BandFloatCount(size_t lineCount) noexcept;
+	void bindViews(const float* data, size_t lines) noexcept;
+public:
+	// streams mono pcm out of ffmpeg and analyzes it while reading
+	static bool Generate(const std::string& ffmpegPath, const std::string& videoPath, OFS_Waveform& output) noexcept;
+
+	bool SaveCache(const CacheKey& key) const noexcept;
+	bool LoadCache(const CacheKey& key) noexcept;
 
-	bool LoadMP3(const std::string& path) noexcept;
-	bool GenerateMP3(const std::string& ffmpegPath, const std::string& videoPath, const std::string& output) noexcept;
-	
 	inline void Clear() noexcept {
-		SamplesLow.clear();
-		SamplesMid.clear();
-		SamplesHigh.clear();
+		storage.clear();
+		mapping.Close();
+		lineCount = 0;
+		rms.fill(nullptr);
+		peaks.fill(nullptr);
+		lods.fill(LOD());
 	}
 
-	inline size_t SampleCount() const noexcept {
-		return SamplesHigh.size(); // all have the same size
-	}
-};
\ No newline at end of file
+	inline size_t SampleCount() const noexcept { return lineCount; }
+	inline const float* Samples(Band band) const noexcept { return rms[band]; }
+	inline const float* Peaks(Band band) const noexcept { return peaks[band]; }
+	inline const LOD& Lod(Band band) const noexcept { return lods[band]; }
+};
@@ -2,10 +2,7 @@
 #include "OFS_ScriptTimeline.h"
 
 ImGradient BaseOverlay::speedGradient;
-std::vector<BaseOverlay::ColoredLine> BaseOverlay::ColoredLines;
-std::vector<ImVec2> BaseOverlay::SelectedActionScreenCoordinates;
-std::vector<ImVec2> BaseOverlay::ActionScreenCoordinates;
-std::vector<FunscriptAction> BaseOverlay::ActionPositionWindow;
+std::vector<BaseOverlay::LODColumn> BaseOverlay::LODColumns;
 bool BaseOverlay::SplineMode = true;
 bool BaseOverlay::ShowActions = true;
 
@@ -30,13 +27,6 @@ BaseOverlay::BaseOverlay(ScriptTimeline* timeline) noexcept
     }
 }
 
-void BaseOverlay::update() noexcept
-{
-    ActionScreenCoordinates.clear();
-    ActionPositionWindow.clear();
-    SelectedActionScreenCoordinates.clear();
-}
-
 void BaseOverlay::DrawSettings() noexcept
 {
 
@@ -58,14 +48,26 @@ float EmptyOverlay::steppingIntervalBackward(float fromMs) noexcept
     return -timeline->frameTimeMs;
 }
 
+int32_t BaseOverlay::LODLevel(Funscript& script, int32_t actionCount, float visibleSizeMs, float canvasWidth) noexcept
+{
+    if (actionCount <= MaxActionsPerPixel * canvasWidth) return -1;
+    return script.LOD().LevelFor(visibleSizeMs / canvasWidth);
+}
+
 void BaseOverlay::DrawActionLines(const OverlayDrawingCtx& ctx) noexcept
 {
     if (!BaseOverlay::ShowActions) return;
     auto& script = *ctx.script;
+    auto& renderer = *ctx.renderer;
+
+    int32_t level = LODLevel(script, ctx.actionToIdx - ctx.actionFromIdx, ctx.visibleSizeMs, ctx.canvas_size.x);
+    if (level >= 0) {
+        DrawActionLinesLOD(ctx, level);
+        return;
+    }
 
     auto startIt = script.Actions().begin() + ctx.actionFromIdx;
     auto endIt = script.Actions().begin() + ctx.actionToIdx;
-    ColoredLines.clear();
 
     auto getPointForAction = [](const OverlayDrawingCtx& ctx, FunscriptAction action) {
         float relative_x = (float)(action.at - ctx.offset_ms) / ctx.visibleSizeMs;
@@ -76,139 +78,79 @@ void BaseOverlay::DrawActionLines(const OverlayDrawingCtx& ctx) noexcept
         return ImVec2(x, y);
     };
 
-
-    auto drawSpline = [](const OverlayDrawingCtx& ctx, float currentTime, float endTime, int32_t color, float width)
-    {
-        constexpr int32_t MinSamplesPerSecond = 60;
-        auto getPointForTimePos = [](const OverlayDrawingCtx& ctx, float timeMs, float pos) {
-            float relative_x = (float)(timeMs - ctx.offset_ms) / ctx.visibleSizeMs;
-            float x = (ctx.canvas_size.x) * relative_x;
-            float y = (ctx.canvas_size.y) * (1 - (pos / 100.f));
-            x += ctx.canvas_pos.x;
-            y += ctx.canvas_pos.y;
-            return ImVec2(x, y);
-        };
-        auto putPoint = [getPointForTimePos](auto& ctx, float timeMs) noexcept {
-            float pos = Util::Clamp<float>(ctx.script->Spline(timeMs) * 100.f, 0.f, 100.f);
-            ctx.draw_list->PathLineTo(getPointForTimePos(ctx, timeMs, pos));
-        };
-
-        ctx.draw_list->PathClear();
-        const float duration = (endTime - currentTime);
-
-        if (ctx.visibleSizeMs / duration >= 100.f)
-        {
-            // for better performance
-            // when splines get really small, they get drawn as straigth lines
-            putPoint(ctx, currentTime);
-            putPoint(ctx, endTime);
-        }
-        else
-        {
-            const float timeStep = duration / (duration * (MinSamplesPerSecond / 1000.f));
-
-            putPoint(ctx, currentTime);
-            currentTime += timeStep;
-            while (currentTime < endTime)
-            {
-                putPoint(ctx, currentTime);
-                currentTime += timeStep;
-            }
-            putPoint(ctx, endTime);
-        }
-
-        ctx.draw_list->PathStroke(color, false, width);
+    auto getSpeedColor = [](const FunscriptAction& action, const FunscriptAction& prevAction) {
+        // calculate speed relative to maximum speed
+        float rel_speed = Util::Clamp<float>((std::abs(action.pos - prevAction.pos) / ((action.at - prevAction.at) / 1000.0f)) / max_speed_per_seconds, 0.f, 1.f);
+        ImColor speed_color;
+        speedGradient.getColorAt(rel_speed, &speed_color.Value.x);
+        speed_color.Value.w = 1.f;
+        return ImGui::ColorConvertFloat4ToU32(speed_color);
     };
 
+    // splines get tessellated by the renderer from the actions
+    OFS_TimelineRenderer::SplineWindow splineWindow{ ctx.canvas_pos, ctx.canvas_size, ctx.offset_ms, ctx.visibleSizeMs };
+    auto& actions = script.Actions();
+
     if (SplineMode)
     {
-        if (startIt != endIt && endIt != script.Actions().end()) {
-            drawSpline(ctx, startIt->at, endIt->at, IM_COL32_BLACK, 7.f);
-        }
-        const FunscriptAction* prevAction = nullptr;
+        renderer.AddSpline(actions, script.ActionsVersion(), ctx.actionFromIdx, ctx.actionToIdx - 1, splineWindow, 7.f, IM_COL32_BLACK);
+        renderer.AddSpeedSpline(actions, script.ActionsVersion(), ctx.actionFromIdx, ctx.actionToIdx - 1, splineWindow, 3.f, max_speed_per_seconds);
         for (; startIt != endIt; startIt++) {
-            auto& action = *startIt;
-            auto p1 = getPointForAction(ctx, action);
-            ActionScreenCoordinates.emplace_back(p1);
-            ActionPositionWindow.emplace_back(action);
-
-            if (prevAction != nullptr) {
-                // calculate speed relative to maximum speed
-                float rel_speed = Util::Clamp<float>((std::abs(action.pos - prevAction->pos) / ((action.at - prevAction->at) / 1000.0f)) / max_speed_per_seconds, 0.f, 1.f);
-                ImColor speed_color;
-                speedGradient.getColorAt(rel_speed, &speed_color.Value.x);
-                speed_color.Value.w = 1.f;
-
-                float currentTime = prevAction->at;
-                float endTime = action.at;
-
-                drawSpline(ctx, currentTime, endTime, ImGui::ColorConvertFloat4ToU32(speed_color), 3.f);
-            }
-            prevAction = &action;
+            auto p = getPointForAction(ctx, *startIt);
+            renderer.AddOverlayPoint(p, 7.f, IM_COL32(0, 0, 0, 255)); // border
+            renderer.AddOverlayPoint(p, 5.f, IM_COL32(255, 0, 0, 255));
         }
     }
     else
     {
+        // this is so that the black background line gets rendered first
         const FunscriptAction* prevAction = nullptr;
-        for (; startIt != endIt; startIt++) {
-            auto& action = *startIt;
+        for (auto it = startIt; it != endIt; it++) {
+            auto& action = *it;
 
             auto p1 = getPointForAction(ctx, action);
-            ActionScreenCoordinates.emplace_back(p1);
-            ActionPositionWindow.emplace_back(action);
+            renderer.AddOverlayPoint(p1, 7.f, IM_COL32(0, 0, 0, 255)); // border
+            renderer.AddOverlayPoint(p1, 5.f, IM_COL32(255, 0, 0, 255));
 
             if (prevAction != nullptr) {
-                // draw line
-                auto p2 = getPointForAction(ctx, *prevAction);
-                // calculate speed relative to maximum speed
-                float rel_speed = Util::Clamp<float>((std::abs(action.pos - prevAction->pos) / ((action.at - prevAction->at) / 1000.0f)) / max_speed_per_seconds, 0.f, 1.f);
-                ImColor speed_color;
-                speedGradient.getColorAt(rel_speed, &speed_color.Value.x);
-                speed_color.Value.w = 1.f;
-                
-                ctx.draw_list->AddLine(p1, p2, IM_COL32(0, 0, 0, 255), 7.0f); // border
-
-                ColoredLines.emplace_back(std::move(BaseOverlay::ColoredLine{ p1, p2, ImGui::ColorConvertFloat4ToU32(speed_color) }));
+                renderer.AddLine(p1, getPointForAction(ctx, *prevAction), IM_COL32(0, 0, 0, 255), 7.0f); // border
             }
-
             prevAction = &action;
         }
 
-        // this is so that the black background line gets rendered first
-        for (auto&& line : ColoredLines) {
-            ctx.draw_list->AddLine(line.p1, line.p2, line.color, 3.f);
+        prevAction = nullptr;
+        for (; startIt != endIt; startIt++) {
+            auto& action = *startIt;
+            if (prevAction != nullptr) {
+                renderer.AddLine(getPointForAction(ctx, action), getPointForAction(ctx, *prevAction), getSpeedColor(action, *prevAction), 3.f);
+            }
+            prevAction = &action;
         }
     }
 
 
     if (script.HasSelection()) {
-        auto startIt = std::find_if(script.Selection().begin(), script.Selection().end(),
-            [&](auto& act) { return act.at >= ctx.offset_ms; });
-        if (startIt != script.Selection().begin())
+        auto& selection = script.Selection();
+        auto startIt = selection.begin() + Funscript::LowerBound(selection, ctx.offset_ms);
+        if (startIt != selection.begin())
             startIt -= 1;
 
-        auto endIt = std::find_if(startIt, script.Selection().end(),
-            [&](auto& act) { return act.at >= ctx.offset_ms + ctx.visibleSizeMs; });
-        if (endIt != script.Selection().end())
+        auto endIt = selection.begin() + Funscript::LowerBound(selection, ctx.offset_ms + ctx.visibleSizeMs);
+        if (endIt != selection.end())
             endIt += 1;
 
         constexpr auto selectedLines = IM_COL32(3, 194, 252, 255);
+        constexpr auto selectedDots = IM_COL32(11, 252, 3, 255);
         if (SplineMode)
         {
-            const FunscriptAction* prev_action = nullptr;
+            // the highlight follows the script between the first & last selected action
+            if (std::distance(startIt, endIt) > 1) {
+                auto fromIdx = std::distance(actions.begin(), std::lower_bound(actions.begin(), actions.end(), *startIt));
+                auto toIdx = std::distance(actions.begin(), std::lower_bound(actions.begin(), actions.end(), *(endIt - 1)));
+                renderer.AddSpline(actions, script.ActionsVersion(), fromIdx, toIdx, splineWindow, 3.f, selectedLines);
+            }
             for (; startIt != endIt; startIt++) {
-                auto&& action = *startIt;
-                auto point = getPointForAction(ctx, action);
-
-                if (prev_action != nullptr) {
-                    // draw highlight line
-                    float currentTime = prev_action->at;
-                    float endTime = action.at;
-                    drawSpline(ctx, currentTime, endTime, selectedLines, false);
-                }
-
-                SelectedActionScreenCoordinates.emplace_back(point);
-                prev_action = &action;
+                renderer.AddOverlayPoint(getPointForAction(ctx, *startIt), 5.f, selectedDots);
             }
         }
         else
@@ -220,14 +162,126 @@ void BaseOverlay::DrawActionLines(const OverlayDrawingCtx& ctx) noexcept
 
                 if (prev_action != nullptr) {
                     // draw highlight line
-                    ctx.draw_list->AddLine(getPointForAction(ctx, *prev_action), point, selectedLines, 3.0f);
+                    renderer.AddLine(getPointForAction(ctx, *prev_action), point, selectedLines, 3.0f);
                 }
 
-                SelectedActionScreenCoordinates.emplace_back(point);
+                renderer.AddOverlayPoint(point, 5.f, selectedDots);
                 prev_action = &action;
             }
         }
     }
+
+    renderer.Flush(ctx.draw_list);
+}
+
+void BaseOverlay::DrawLODColumns(const OverlayDrawingCtx& ctx, bool selection) noexcept
+{
+    auto& renderer = *ctx.renderer;
+    const float msPerPixel = ctx.visibleSizeMs / ctx.canvas_size.x;
+    auto getY = [&ctx](int32_t pos) noexcept {
+        return ctx.canvas_pos.y + ctx.canvas_size.y * (1.f - (pos / 100.f));
+    };
+
+    // each column is a vertical line over its envelope joined to the previous column
+    auto drawColumns = [&](auto getColor, float thickness) noexcept {
+        const LODColumn* prev = nullptr;
+        for (auto& column : LODColumns) {
+            uint32_t color = getColor(column, prev);
+            if (prev != nullptr) {
+                renderer.AddLine(ImVec2(prev->x, getY(prev->envelope.last)), ImVec2(column.x, getY(column.envelope.first)), color, thickness);
+            }
+            renderer.AddLine(ImVec2(column.x, getY(column.envelope.max)), ImVec2(column.x, getY(column.envelope.min)), color, thickness);
+            prev = &column;
+        }
+    };
+
+    if (selection) {
+        constexpr auto selectedLines = IM_COL32(3, 194, 252, 255);
+        drawColumns([](auto&, auto) noexcept { return selectedLines; }, 3.f);
+        return;
+    }
+
+    drawColumns([](auto&, auto) noexcept { return IM_COL32(0, 0, 0, 255); }, 7.f); // border
+    drawColumns([msPerPixel](const LODColumn& column, const LODColumn* prev) noexcept {
+        // the travel is spread over the time since the previous column
+        float pixels = prev != nullptr ? std::max(column.x - prev->x, 1.f) : 1.f;
+        float seconds = (pixels * msPerPixel) / 1000.f;
+        float rel_speed = Util::Clamp<float>((column.envelope.travel / seconds) / max_speed_per_seconds, 0.f, 1.f);
+        ImColor speed_color;
+        speedGradient.getColorAt(rel_speed, &speed_color.Value.x);
+        speed_color.Value.w = 1.f;
+        return ImGui::ColorConvertFloat4ToU32(speed_color);
+    }, 3.f);
+}
+
+void BaseOverlay::DrawActionLinesLOD(const OverlayDrawingCtx& ctx, int32_t level) noexcept
+{
+    auto& script = *ctx.script;
+    auto& lod = script.LOD();
+    auto& buckets = lod.Level(level);
+    const float bucketMs = lod.BucketMs(level);
+    const float msPerPixel = ctx.visibleSizeMs / ctx.canvas_size.x;
+
+    const float originMs = lod.OriginMs();
+
+    auto columnFor = [&ctx, msPerPixel](float timeMs) noexcept {
+        return (int32_t)std::floor((timeMs - ctx.offset_ms) / msPerPixel);
+    };
+    auto addToColumn = [&ctx](int32_t column, const FunscriptLOD::Bucket& envelope) noexcept {
+        float x = ctx.canvas_pos.x + column + 0.5f;
+        if (!LODColumns.empty() && LODColumns.back().x == x) {
+            LODColumns.back().envelope.Merge(envelope);
+        }
+        else {
+            LODColumns.emplace_back(LODColumn{ x, envelope });
+        }
+    };
+    auto actionEnvelope = [](const FunscriptAction& action) noexcept {
+        FunscriptLOD::Bucket envelope;
+        envelope.min = envelope.max = envelope.first = envelope.last = action.pos;
+        return envelope;
+    };
+
+    // the visible buckets are at most two per pixel
+    const int32_t firstBucket = std::max<float>(0.f, std::floor((ctx.offset_ms - originMs) / bucketMs));
+    const int32_t lastBucket = std::min<float>((float)buckets.size() - 1.f, std::floor((ctx.offset_ms + ctx.visibleSizeMs - originMs) / bucketMs));
+
+    // the actions right outside of the window keep the lines going to the edges
+    auto& firstAction = script.Actions()[ctx.actionFromIdx];
+    auto& lastAction = script.Actions()[ctx.actionToIdx - 1];
+
+    LODColumns.clear();
+    if (firstAction.at < originMs + firstBucket * bucketMs) {
+        addToColumn(columnFor(firstAction.at), actionEnvelope(firstAction));
+    }
+    for (int32_t i = firstBucket; i <= lastBucket; i++) {
+        auto& bucket = buckets[i];
+        if (bucket.Empty()) continue;
+        addToColumn(columnFor(originMs + i * bucketMs), bucket);
+    }
+    if (lastAction.at >= originMs + (lastBucket + 1) * bucketMs) {
+        addToColumn(columnFor(lastAction.at), actionEnvelope(lastAction));
+    }
+    DrawLODColumns(ctx, false);
+
+    if (script.HasSelection()) {
+        // selections are usually small enough to be binned directly
+        auto& selection = script.Selection();
+        auto startIt = selection.begin() + Funscript::LowerBound(selection, ctx.offset_ms);
+        if (startIt != selection.begin())
+            startIt -= 1;
+        auto endIt = selection.begin() + Funscript::LowerBound(selection, ctx.offset_ms + ctx.visibleSizeMs);
+        if (endIt != selection.end())
+            endIt += 1;
+
+        LODColumns.clear();
+        for (; startIt != endIt; startIt++) {
+            addToColumn(columnFor(startIt->at), actionEnvelope(*startIt));
+        }
+        DrawLODColumns(ctx, true);
+    }
+
+    ctx.renderer->Flush(ctx.draw_list);
 }
 
 void BaseOverlay::DrawSecondsLabel(const OverlayDrawingCtx& ctx) noexcept
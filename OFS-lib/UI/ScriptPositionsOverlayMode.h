@@ -6,6 +6,8 @@
 #include "imgui.h"
 #include "imgui_internal.h"
 #include "GradientBar.h"
+#include "OFS_TimelineRenderer.h"
+#include "OFS_TimelineLaneCache.h"
 
 struct OverlayDrawingCtx {
 	Funscript* script;
@@ -14,6 +16,7 @@ struct OverlayDrawingCtx {
 	int32_t actionFromIdx;
 	int32_t actionToIdx;
 	ImDrawList* draw_list;
+	OFS_TimelineRenderer* renderer;
 	float visibleSizeMs;
 	float offset_ms;
 	float totalDurationMs;
@@ -24,19 +27,21 @@ struct OverlayDrawingCtx {
 class BaseOverlay {
 protected:
 	class ScriptTimeline* timeline;
-public:
-	struct ColoredLine {
-		ImVec2 p1;
-		ImVec2 p2;
-		uint32_t color;
+
+	// one pixel column of a zoomed out timeline
+	struct LODColumn {
+		float x;
+		FunscriptLOD::Bucket envelope;
 	};
-	static std::vector<ColoredLine> ColoredLines;
-	static std::vector<FunscriptAction> ActionPositionWindow;
-	static std::vector<ImVec2> SelectedActionScreenCoordinates;
-	static std::vector<ImVec2> ActionScreenCoordinates;
+	static std::vector<LODColumn> LODColumns;
+	static void DrawLODColumns(const OverlayDrawingCtx& ctx, bool selection) noexcept;
+	static void DrawActionLinesLOD(const OverlayDrawingCtx& ctx, int32_t level) noexcept;
+public:
 	static ImGradient speedGradient;
 	// used for calculating stroke color with speedGradient
 	static constexpr float max_speed_per_seconds = 530.f; // arbitrarily choosen maximum tuned for coloring
+	// above this many actions per pixel the lines get drawn from the script LOD
+	static constexpr float MaxActionsPerPixel = 2.f;
 	static bool SplineMode;
 	static bool ShowActions;
 
@@ -44,14 +49,19 @@ public:
 	virtual ~BaseOverlay() noexcept {}
 	virtual void DrawSettings() noexcept;
 
-	virtual void update() noexcept;
 	virtual void DrawScriptPositionContent(const OverlayDrawingCtx& ctx) noexcept {}
+	// adds all state DrawScriptPositionContent depends on besides the ctx
+	// cached lanes get redrawn when it changes
+	virtual void AddContentKey(OFS_TimelineLaneCache::ContentKey& key) noexcept {}
 	virtual void nextFrame() noexcept {}
 	virtual void previousFrame() noexcept {}
 
 	virtual float steppingIntervalForward(float fromMs) noexcept = 0;
 	virtual float steppingIntervalBackward(float fromMs) noexcept = 0;
 
+	// LOD level the action lines get drawn with or -1 for full detail
+	// actionCount is the number of actions in the window including the ones right outside
+	static int32_t LODLevel(Funscript& script, int32_t actionCount, float visibleSizeMs, float canvasWidth) noexcept;
 	static void DrawActionLines(const OverlayDrawingCtx& ctx) noexcept;
 	static void DrawSecondsLabel(const OverlayDrawingCtx& ctx) noexcept;
 	static void DrawHeightLines(const OverlayDrawingCtx& ctx) noexcept;
@@ -2,34 +2,16 @@
 #include "EventSystem.h"
 #include "EventSystem.h"
 
-EventSystem* EventSystem::instance = nullptr;
-
-int32_t EventSystem::SingleShotEvent = 0;
-int32_t EventSystem::WaitableSingleShotEvent = 0;
-
-void EventSystem::SingleShotHandler(SDL_Event& ev) noexcept
-{
-	SingleShotEventData* data = (SingleShotEventData*)ev.user.data1;
-	data->handler(data->ctx);
-	delete data;
-}
+#include <algorithm>
+#include <chrono>
 
-void EventSystem::WaitableSingleShotHandler(SDL_Event& ev) noexcept
-{
-	WaitableSingleShotEventData* data = (WaitableSingleShotEventData*)ev.user.data1;
-	data->handler(data->ctx);
-	SDL_SemPost(data->waitSemaphore);
-	// gets deleted by the waiting thread
-}
+EventSystem* EventSystem::instance = nullptr;
 
 void EventSystem::setup()
 {
 	FUN_ASSERT(instance == nullptr, "only one instance");
 	instance = this;
-	SingleShotEvent = SDL_RegisterEvents(1);
-	WaitableSingleShotEvent = SDL_RegisterEvents(1);
-	Subscribe(SingleShotEvent, EVENT_SYSTEM_BIND(this, &EventSystem::SingleShotHandler));
-	Subscribe(WaitableSingleShotEvent, EVENT_SYSTEM_BIND(this, &EventSystem::WaitableSingleShotHandler));
+	tasks.WakeupEvent = SDL_RegisterEvents(1);
 }
 
 void EventSystem::PushEvent(int32_t type, void* user1) noexcept
@@ -40,64 +22,144 @@ void EventSystem::PushEvent(int32_t type, void* user1) noexcept
 	SDL_PushEvent(&ev);
 }
 
+int32_t EventSystem::findSlot(int32_t eventType) const noexcept
+{
+	auto it = std::lower_bound(typeIndex.begin(), typeIndex.end(), eventType,
+		[](auto& entry, int32_t type) { return entry.first < type; });
+	if (it == typeIndex.end() || it->first != eventType) return -1;
+	return it->second;
+}
+
+void EventSystem::removeDisabled() noexcept
+{
+	for (auto& list : handlerLists) {
+		list.handlers.erase(std::remove_if(list.handlers.begin(), list.handlers.end(),
+			[](auto& h) { return !h.func; }), list.handlers.end());
+	}
+	needsCompaction = false;
+}
+
 void EventSystem::PushEvent(SDL_Event& event) noexcept
 {
-	for (auto& handler : handlers) {
-		if (handler.eventType == event.type)
-			handler.func(event);
+	int32_t slot = findSlot(event.type);
+	if (slot < 0) return;
+
+	dispatchDepth++;
+	// handlers may subscribe while this runs which can reallocate the vector
+	for (size_t i = 0; i < handlerLists[slot].handlers.size(); i++) {
+		auto func = handlerLists[slot].handlers[i].func;
+		if (func) func(event);
 	}
+	dispatchDepth--;
+	if (dispatchDepth == 0 && needsCompaction) removeDisabled();
 }
 
-void EventSystem::Subscribe(int32_t eventType, void* listener, EventHandlerFunc&& handler) noexcept
+void EventSystem::Subscribe(int32_t eventType, void* listener, EventDelegate handler) noexcept
 {
 	// this excects the listener to never relocate
-	handlers.emplace_back(eventType, listener, handler);
+	int32_t slot = findSlot(eventType);
+	if (slot < 0) {
+		slot = handlerLists.size();
+		handlerLists.push_back({ eventType, {} });
+		auto it = std::lower_bound(typeIndex.begin(), typeIndex.end(), eventType,
+			[](auto& entry, int32_t type) { return entry.first < type; });
+		typeIndex.insert(it, std::make_pair(eventType, slot));
+	}
+	handlerLists[slot].handlers.emplace_back(listener, handler);
 }
 
 void EventSystem::Unsubscribe(int32_t eventType, void* listener) noexcept
 {
 	// this excects the listener to never relocate
-	auto it = std::find_if(handlers.begin(), handlers.end(),
-		[&](auto& handler) {
-			return handler.listener == listener && handler.eventType == eventType;
-	});
+	int32_t slot = findSlot(eventType);
+	if (slot >= 0) {
+		auto& handlers = handlerLists[slot].handlers;
+		auto it = std::find_if(handlers.begin(), handlers.end(),
+			[&](auto& handler) {
+				return handler.listener == listener && handler.func;
+		});
+		if (it != handlers.end()) {
+			if (dispatchDepth > 0) {
+				it->func = EventDelegate();
+				needsCompaction = true;
+			}
+			else {
+				handlers.erase(it);
+			}
+			return;
+		}
+	}
+	LOGF_ERROR("Failed to unsubscribe event. \"%d\"", eventType);
+	FUN_ASSERT(false, "please investigate");
+}
 
-	if (it != handlers.end()) {
-		handlers.erase(it);
+void EventSystem::UnsubscribeAll(void* listener) noexcept
+{
+	for (auto& list : handlerLists) {
+		for (auto& handler : list.handlers) {
+			if (handler.listener == listener) handler.func = EventDelegate();
+		}
+	}
+	if (dispatchDepth > 0) {
+		needsCompaction = true;
 	}
 	else {
-		LOGF_ERROR("Failed to unsubscribe event. \"%d\"", eventType);
-		FUN_ASSERT(false, "please investigate");
+		removeDisabled();
 	}
 }
 
-void EventSystem::UnsubscribeAll(void* listener) noexcept
+void EventSystem::SingleShot(SingleShotEventHandler&& handler, void* ctx) noexcept
 {
-	auto it = handlers.erase(std::remove_if(handlers.begin(), handlers.end(),
-		[listener](auto&& h) {
-			return h.listener == listener;
-		}), handlers.end());
+	ev().tasks.Push(std::move(handler), ctx);
 }
 
-void EventSystem::SingleShot(SingleShotEventHandler&& handler, void* ctx) noexcept
+std::future<void> EventSystem::WaitableSingleShot(SingleShotEventHandler&& handler, void* ctx) noexcept
 {
-	// evData is freed after the event got processed
-	auto evData = new SingleShotEventData();
-	evData->ctx = ctx;
-	evData->handler = std::move(handler);
-	SDL_Event ev;
-	ev.type = EventSystem::SingleShotEvent;
-	ev.user.data1 = evData;
-	SDL_PushEvent(&ev);
+	return ev().tasks.PushWaitable(std::move(handler), ctx);
 }
 
-std::unique_ptr<EventSystem::WaitableSingleShotEventData> EventSystem::WaitableSingleShot(SingleShotEventHandler&& handler, void* ctx) noexcept
+void EventSystem::Benchmark() noexcept
 {
-	auto data = std::make_unique<WaitableSingleShotEventData>(ctx,  std::move(handler));
-	SDL_Event ev;
-	ev.type = EventSystem::WaitableSingleShotEvent;
-	ev.user.data1 = (void*)data.get();
-	SDL_SemWait(data->waitSemaphore);
-	SDL_PushEvent(&ev);
-	return data;
+	struct Listener {
+		int64_t calls = 0;
+		void handle(SDL_Event& ev) noexcept { calls++; }
+	};
+	// most handlers listen to other events, a few to mouse motion
+	constexpr int32_t EventTypes = 32;
+	constexpr int32_t Events = 100000;
+	const int32_t handlerCounts[] = { 16, 64, 256, 1024 };
+
+	for (int32_t handlerCount : handlerCounts) {
+		std::vector<Listener> listeners(handlerCount);
+		// the way dispatch worked before. a linear scan over std::functions
+		std::vector<std::pair<int32_t, std::function<void(SDL_Event&)>>> linear;
+		EventSystem indexed;
+		for (int32_t i = 0; i < handlerCount; i++) {
+			int32_t type = i % EventTypes == 0 ? SDL_MOUSEMOTION : SDL_USEREVENT + (i % EventTypes);
+			auto listener = &listeners[i];
+			linear.emplace_back(type, std::bind(&Listener::handle, listener, std::placeholders::_1));
+			indexed.Subscribe(type, EVENT_SYSTEM_BIND(listener, &Listener::handle));
+		}
+
+		SDL_Event ev;
+		ev.type = SDL_MOUSEMOTION;
+		auto startTime = std::chrono::high_resolution_clock::now();
+		for (int32_t i = 0; i < Events; i++) {
+			for (auto& handler : linear) {
+				if (handler.first == ev.type) handler.second(ev);
+			}
+		}
+		auto linearPerEvent = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - startTime) / Events;
+
+		startTime = std::chrono::high_resolution_clock::now();
+		for (int32_t i = 0; i < Events; i++) {
+			indexed.PushEvent(ev);
+		}
+		auto indexedPerEvent = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - startTime) / Events;
+
+		int64_t calls = 0;
+		for (auto& listener : listeners) calls += listener.calls;
+		LOGF_INFO("Event dispatch benchmark: %d handlers. linear std::function: %.1f ns/event, indexed delegates: %.1f ns/event, calls match: %s",
+			handlerCount, linearPerEvent.count(), indexedPerEvent.count(), calls == 2 * (int64_t)Events * ((handlerCount + EventTypes - 1) / EventTypes) ? "yes" : "no");
+	}
 }
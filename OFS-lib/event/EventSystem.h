@@ -2,6 +2,7 @@
 #include "OFS_Util.h"
 #include "SDL_events.h"
 #include "SDL_thread.h"
+#include "OFS_TaskQueue.h"
 
 #include <vector>
 #include <functional>
@@ -9,66 +10,80 @@
 
 // insanely basic event system
 // it doesn't get any simpler than this
-using EventHandlerFunc = std::function<void(SDL_Event&)>;
+
+// a bound member function. two pointers instead of a std::function
+class EventDelegate {
+public:
+	using StubFunc = void(*)(void*, SDL_Event&);
+	void* object = nullptr;
+	StubFunc stub = nullptr;
+
+	template<auto Method, typename T>
+	static EventDelegate Bind(T* object) noexcept {
+		EventDelegate delegate;
+		delegate.object = object;
+		delegate.stub = [](void* obj, SDL_Event& ev) { (static_cast<T*>(obj)->*Method)(ev); };
+		return delegate;
+	}
+
+	inline explicit operator bool() const noexcept { return stub != nullptr; }
+	inline void operator()(SDL_Event& ev) const noexcept { stub(object, ev); }
+};
 
 class EventHandler {
 public:
-	int32_t eventType;
-	EventHandlerFunc func;
 	void* listener = nullptr;
+	EventDelegate func;
 
-	EventHandler(int32_t type, void* listener, EventHandlerFunc func)
-		: eventType(type), func(func), listener(listener) { }
+	EventHandler(void* listener, EventDelegate func)
+		: listener(listener), func(func) { }
 };
 
 class EventSystem {
 private:
-	std::vector<EventHandler> handlers;
+	// handlers of one event type. lists never move to another slot
+	struct HandlerList {
+		int32_t eventType;
+		std::vector<EventHandler> handlers;
+	};
+	std::vector<HandlerList> handlerLists;
+	// sorted by event type, maps to the slot in handlerLists
+	std::vector<std::pair<int32_t, int32_t>> typeIndex;
 
-	void SingleShotHandler(SDL_Event& ev) noexcept;
-	void WaitableSingleShotHandler(SDL_Event& ev) noexcept;
+	// handlers can unsubscribe while an event is dispatched
+	// they get disabled & removed after the dispatch
+	int32_t dispatchDepth = 0;
+	bool needsCompaction = false;
+
+	int32_t findSlot(int32_t eventType) const noexcept;
+	void removeDisabled() noexcept;
+
+	// replaces pushing heap allocated payloads through the sdl event queue
+	OFS_TaskQueue tasks;
 public:
-	using SingleShotEventHandler = std::function<void(void*)>;
-	struct SingleShotEventData {
-		void* ctx = nullptr;
-		SingleShotEventHandler handler;
-	};
-	// this event + SingleShotEventData + SingleShotHandler allows execute arbitrary code
-	// back on the main thread comming from another. currently this is used to return filepaths from file dialogs.
-	static int32_t SingleShotEvent;
-	
-	struct WaitableSingleShotEventData {
-		void* ctx;
-		SingleShotEventHandler handler;
-		SDL_sem* waitSemaphore;
-
-		WaitableSingleShotEventData(void* ctx, SingleShotEventHandler&& handler) noexcept
-			: ctx(ctx), handler(handler)
-		{
-			waitSemaphore = SDL_CreateSemaphore(1);
-		}
-		~WaitableSingleShotEventData() noexcept
-		{
-			SDL_DestroySemaphore(waitSemaphore);
-		}
-
-		void wait() noexcept { SDL_SemWait(waitSemaphore); }
-		bool try_wait() noexcept { return SDL_SemTryWait(waitSemaphore) == 0; }
-	};
-	static int32_t WaitableSingleShotEvent;
+	using SingleShotEventHandler = OFS_TaskQueue::TaskFunc;
 
 	void setup();
 
 
 	void PushEvent(SDL_Event& event) noexcept;
-	void Subscribe(int32_t eventType, void* listener, EventHandlerFunc&& handler) noexcept;
+	void Subscribe(int32_t eventType, void* listener, EventDelegate handler) noexcept;
 	void Unsubscribe(int32_t eventType, void* listener) noexcept;
 	void UnsubscribeAll(void* listener) noexcept;
 
+	// runs the queued single shots. has to be called by the main loop outside of the imgui frame
+	inline size_t ProcessTasks() noexcept { return tasks.Process(); }
+	inline OFS_TaskQueue::Metrics TaskMetrics() const noexcept { return tasks.GetMetrics(); }
+
 	// helper
 	static void PushEvent(int32_t type, void* user1 = nullptr) noexcept;
+	// executes the handler on the main thread. can be called from any thread
 	static void SingleShot(SingleShotEventHandler&& handler, void* ctx) noexcept;
-	[[nodiscard/*("this must be waited on")*/]]static std::unique_ptr<WaitableSingleShotEventData> WaitableSingleShot(SingleShotEventHandler&& handler, void* ctx) noexcept;
+	// same as SingleShot but the future is ready once the handler ran. don't wait on the main thread
+	[[nodiscard]] static std::future<void> WaitableSingleShot(SingleShotEventHandler&& handler, void* ctx) noexcept;
+
+	// logs the dispatch cost of a mouse motion event as the handler count grows
+	static void Benchmark() noexcept;
 
 	static EventSystem* instance;
 	static EventSystem& ev() noexcept {
@@ -77,4 +92,4 @@ public:
 	}
 };
 
-#define EVENT_SYSTEM_BIND(listener, handler) listener, std::move(std::bind(handler, listener, std::placeholders::_1))
\ No newline at end of file
+#define EVENT_SYSTEM_BIND(listener, handler) listener, EventDelegate::Bind<handler>(listener)
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include "OFS_TaskQueue.h"
+
+#include "SDL_events.h"
+
+OFS_TaskQueue::OFS_TaskQueue() noexcept
+{
+	cells = std::make_unique<Cell[]>(Capacity);
+	for (size_t i = 0; i < Capacity; i++) {
+		cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+	overflowMutex = SDL_CreateMutex();
+}
+
+OFS_TaskQueue::~OFS_TaskQueue() noexcept
+{
+	SDL_DestroyMutex(overflowMutex);
+}
+
+bool OFS_TaskQueue::tryPush(Task& task) noexcept
+{
+	size_t pos = enqueuePos.load(std::memory_order_relaxed);
+	for (;;) {
+		auto& cell = cells[pos & Mask];
+		size_t seq = cell.sequence.load(std::memory_order_acquire);
+		intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+		if (diff == 0) {
+			// claim the cell
+			if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+				cell.task = std::move(task);
+				cell.sequence.store(pos + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (diff < 0) {
+			// the main thread hasn't processed the task from one lap ago
+			return false;
+		}
+		else {
+			pos = enqueuePos.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+size_t OFS_TaskQueue::currentDepth() const noexcept
+{
+	// the main thread can move dequeuePos past the enqueuePos which was read before it
+	const size_t enqueued = enqueuePos.load(std::memory_order_relaxed);
+	const size_t dequeued = dequeuePos.load(std::memory_order_relaxed);
+	return (enqueued > dequeued ? enqueued - dequeued : 0) + overflowDepth.load(std::memory_order_relaxed);
+}
+
+void OFS_TaskQueue::push(Task&& task) noexcept
+{
+	// once overflowing everything goes into the overflow to keep the order
+	if (overflowing.load(std::memory_order_acquire) || !tryPush(task)) {
+		SDL_LockMutex(overflowMutex);
+		overflow.emplace_back(std::move(task));
+		overflowDepth.store(overflow.size(), std::memory_order_relaxed);
+		overflowing.store(true, std::memory_order_release);
+		SDL_UnlockMutex(overflowMutex);
+		overflowed.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	size_t depth = currentDepth();
+	size_t peak = peakDepth.load(std::memory_order_relaxed);
+	while (depth > peak && !peakDepth.compare_exchange_weak(peak, depth, std::memory_order_relaxed)) {}
+
+	if (WakeupEvent != 0 && !wakeupPending.exchange(true)) {
+		// if this gets dropped the tasks still run on the next frame
+		SDL_Event ev{ 0 };
+		ev.type = WakeupEvent;
+		SDL_PushEvent(&ev);
+	}
+}
+
+void OFS_TaskQueue::Push(TaskFunc&& func, void* ctx) noexcept
+{
+	Task task;
+	task.func = std::move(func);
+	task.ctx = ctx;
+	push(std::move(task));
+}
+
+std::future<void> OFS_TaskQueue::PushWaitable(TaskFunc&& func, void* ctx) noexcept
+{
+	Task task;
+	task.func = std::move(func);
+	task.ctx = ctx;
+	task.done.emplace();
+	auto future = task.done->get_future();
+	push(std::move(task));
+	return future;
+}
+
+void OFS_TaskQueue::run(Task& task) noexcept
+{
+	task.func(task.ctx);
+	if (task.done) task.done->set_value();
+}
+
+size_t OFS_TaskQueue::Process() noexcept
+{
+	wakeupPending.store(false);
+	const size_t end = enqueuePos.load(std::memory_order_acquire);
+	size_t pos = dequeuePos.load(std::memory_order_relaxed);
+	size_t count = 0;
+	while (pos != end) {
+		auto& cell = cells[pos & Mask];
+		// a producer claimed the cell but is still writing
+		if (cell.sequence.load(std::memory_order_acquire) != pos + 1) break;
+		Task task = std::move(cell.task);
+		cell.task = Task();
+		cell.sequence.store(pos + Capacity, std::memory_order_release);
+		pos++;
+		dequeuePos.store(pos, std::memory_order_relaxed);
+		run(task);
+		count++;
+	}
+
+	// overflowed tasks are younger than everything in the ring
+	if (overflowing.load(std::memory_order_acquire) && pos == enqueuePos.load(std::memory_order_acquire)) {
+		std::vector<Task> tasks;
+		SDL_LockMutex(overflowMutex);
+		tasks.swap(overflow);
+		overflowDepth.store(0, std::memory_order_relaxed);
+		overflowing.store(false, std::memory_order_release);
+		SDL_UnlockMutex(overflowMutex);
+		for (auto& task : tasks) {
+			run(task);
+			count++;
+		}
+	}
+	processed += count;
+	return count;
+}
+
+OFS_TaskQueue::Metrics OFS_TaskQueue::GetMetrics() const noexcept
+{
+	Metrics metrics;
+	metrics.depth = currentDepth();
+	metrics.peakDepth = peakDepth.load(std::memory_order_relaxed);
+	metrics.processed = processed;
+	metrics.overflowed = overflowed.load(std::memory_order_relaxed);
+	return metrics;
+}
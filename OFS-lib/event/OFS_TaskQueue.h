@@ -0,0 +1,83 @@
+#pragma once
+
+#include "SDL_mutex.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <vector>
+
+// tasks from any thread which run on the main thread
+// lock-free bounded ring with many producers & the main thread as the only consumer
+// if the ring is full tasks go into a locked overflow list instead of getting dropped
+class OFS_TaskQueue
+{
+public:
+	using TaskFunc = std::function<void(void*)>;
+	static constexpr size_t Capacity = 1024;
+	static_assert((Capacity & (Capacity - 1)) == 0, "has to be a power of two");
+
+	struct Metrics {
+		size_t depth = 0;
+		size_t peakDepth = 0;
+		uint64_t processed = 0;
+		uint64_t overflowed = 0;
+	};
+private:
+	struct Task {
+		TaskFunc func;
+		void* ctx = nullptr;
+		// only waitable tasks have a promise
+		std::optional<std::promise<void>> done;
+	};
+	struct Cell {
+		// equal to the position when free, position + 1 when it holds a task
+		std::atomic<size_t> sequence;
+		Task task;
+	};
+	static constexpr size_t Mask = Capacity - 1;
+
+	std::unique_ptr<Cell[]> cells;
+	alignas(64) std::atomic<size_t> enqueuePos = 0;
+	alignas(64) std::atomic<size_t> dequeuePos = 0;
+
+	SDL_mutex* overflowMutex = nullptr;
+	std::vector<Task> overflow;
+	std::atomic<bool> overflowing = false;
+	std::atomic<size_t> overflowDepth = 0;
+
+	// only one wakeup event is in the sdl queue at a time
+	std::atomic<bool> wakeupPending = false;
+
+	std::atomic<size_t> peakDepth = 0;
+	std::atomic<uint64_t> overflowed = 0;
+	uint64_t processed = 0;
+
+	// approximate when called from a producer
+	size_t currentDepth() const noexcept;
+	bool tryPush(Task& task) noexcept;
+	void push(Task&& task) noexcept;
+	static void run(Task& task) noexcept;
+public:
+	// pushed to wake up the main loop while it waits for events. 0 disables it
+	int32_t WakeupEvent = 0;
+
+	OFS_TaskQueue() noexcept;
+	~OFS_TaskQueue() noexcept;
+
+	OFS_TaskQueue(const OFS_TaskQueue&) = delete;
+	OFS_TaskQueue& operator=(const OFS_TaskQueue&) = delete;
+
+	void Push(TaskFunc&& func, void* ctx) noexcept;
+	// the future is ready once the task ran. never wait on it from the main thread
+	std::future<void> PushWaitable(TaskFunc&& func, void* ctx) noexcept;
+
+	// main thread only. runs the tasks queued before the call
+	// tasks queued by these tasks run during the next call
+	size_t Process() noexcept;
+
+	Metrics GetMetrics() const noexcept;
+};
@@ -0,0 +1,167 @@
+#include "OFS_FrameExporter.h"
+#include "OFS_Util.h"
+
+#include "SDL_cpuinfo.h"
+#include "stb_image_write.h"
+
+#include <cstring>
+
+int OFS_FrameExporter::worker(void* user) noexcept
+{
+	auto& exporter = *(OFS_FrameExporter*)user;
+	for (;;) {
+		SDL_LockMutex(exporter.mutex);
+		while (exporter.jobs.empty() && !exporter.shutdown) {
+			SDL_CondWait(exporter.jobAvailable, exporter.mutex);
+		}
+		if (exporter.jobs.empty()) {
+			SDL_UnlockMutex(exporter.mutex);
+			break;
+		}
+		auto job = std::move(exporter.jobs.front());
+		exporter.jobs.pop_front();
+		SDL_UnlockMutex(exporter.mutex);
+
+		int succ = 0;
+		switch (job.format) {
+		case Format::Jpg:
+			succ = stbi_write_jpg(job.filename.c_str(), job.w, job.h, 4, job.dataBuffer, JpgQuality);
+			break;
+		default:
+			succ = stbi_write_png(job.filename.c_str(), job.w, job.h, 4, job.dataBuffer, job.w * 4);
+			break;
+		}
+		if (!succ) {
+			LOGF_ERROR("Failed to write \"%s\"", job.filename.c_str());
+		}
+		delete[] job.dataBuffer;
+		exporter.encoding--;
+	}
+	return 0;
+}
+
+void OFS_FrameExporter::Init() noexcept
+{
+	if (mutex != nullptr) return;
+	mutex = SDL_CreateMutex();
+	jobAvailable = SDL_CreateCond();
+	shutdown = false;
+	// encoding is way slower than the readback
+	const int32_t workerCount = Util::Clamp(SDL_GetCPUCount() / 2, 1, 4);
+	for (int32_t i = 0; i < workerCount; i++) {
+		workers.emplace_back(SDL_CreateThread(worker, "OFS_FrameExporter", this));
+	}
+}
+
+void OFS_FrameExporter::Shutdown() noexcept
+{
+	if (mutex == nullptr) return;
+	for (auto& buffer : buffers) {
+		if (buffer.fence != nullptr) finish(buffer, true);
+		if (buffer.pbo != 0) {
+			glDeleteBuffers(1, &buffer.pbo);
+			buffer.pbo = 0;
+			buffer.capacity = 0;
+		}
+	}
+
+	SDL_LockMutex(mutex);
+	shutdown = true;
+	SDL_CondBroadcast(jobAvailable);
+	SDL_UnlockMutex(mutex);
+	for (auto thread : workers) {
+		SDL_WaitThread(thread, nullptr);
+	}
+	workers.clear();
+	SDL_DestroyCond(jobAvailable);
+	SDL_DestroyMutex(mutex);
+	jobAvailable = nullptr;
+	mutex = nullptr;
+}
+
+bool OFS_FrameExporter::finish(PixelBuffer& buffer, bool wait) noexcept
+{
+	GLenum status = glClientWaitSync(buffer.fence, GL_SYNC_FLUSH_COMMANDS_BIT, wait ? UINT64_MAX : 0);
+	if (status == GL_TIMEOUT_EXPIRED) return false;
+	glDeleteSync(buffer.fence);
+	buffer.fence = nullptr;
+	if (status == GL_WAIT_FAILED) {
+		LOG_ERROR("Frame readback failed.");
+		return true;
+	}
+
+	const size_t size = (size_t)buffer.w * buffer.h * 4;
+	ScreenshotSavingThreadData job;
+	job.w = buffer.w;
+	job.h = buffer.h;
+	job.filename = std::move(buffer.filename);
+	job.format = buffer.format;
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.pbo);
+	auto pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+	if (pixels != nullptr) {
+		// the readback starts with the bottom row but image files start at the top
+		// flipping here keeps the encoders away from stb's global flip flag
+		const size_t rowBytes = (size_t)buffer.w * 4;
+		job.dataBuffer = new uint8_t[size];
+		for (int y = 0; y < buffer.h; y++) {
+			std::memcpy(job.dataBuffer + y * rowBytes, (const uint8_t*)pixels + (buffer.h - 1 - y) * rowBytes, rowBytes);
+		}
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	if (job.dataBuffer == nullptr) {
+		LOG_ERROR("Failed to map frame readback.");
+		return true;
+	}
+
+	encoding++;
+	SDL_LockMutex(mutex);
+	jobs.emplace_back(std::move(job));
+	SDL_CondSignal(jobAvailable);
+	SDL_UnlockMutex(mutex);
+	return true;
+}
+
+void OFS_FrameExporter::Capture(unsigned int framebuffer, int w, int h, const std::string& filename, Format format) noexcept
+{
+	Init();
+	auto& buffer = buffers[nextBuffer];
+	nextBuffer = (nextBuffer + 1) % PixelBufferCount;
+	if (buffer.fence != nullptr) {
+		finish(buffer, true);
+	}
+
+	const size_t size = (size_t)w * h * 4;
+	if (buffer.pbo == 0) {
+		glGenBuffers(1, &buffer.pbo);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.pbo);
+	if (buffer.capacity != size) {
+		glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+		buffer.capacity = size;
+	}
+
+	GLint prevFramebuffer = 0;
+	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &prevFramebuffer);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+	glReadBuffer(GL_COLOR_ATTACHMENT0);
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+	// matches the rgba8 render targets so the readback is a plain copy. mpv writes opaque alpha
+	glReadPixels(0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, prevFramebuffer);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	buffer.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	buffer.w = w;
+	buffer.h = h;
+	buffer.filename = filename;
+	buffer.format = format;
+}
+
+void OFS_FrameExporter::Update() noexcept
+{
+	for (auto& buffer : buffers) {
+		if (buffer.fence != nullptr) finish(buffer, false);
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <deque>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <cstdint>
+
+#include "glad/glad.h"
+
+#include "SDL_thread.h"
+#include "SDL_mutex.h"
+
+// asynchronous readback of a framebuffer into image files
+// glReadPixels goes into a pixel buffer object & returns immediately
+// the buffer gets mapped a few frames later once the gpu is done
+// & the pixels are encoded by a pool of worker threads
+class OFS_FrameExporter
+{
+public:
+	enum Format : int32_t {
+		Png,
+		Jpg,
+	};
+	static constexpr int32_t PixelBufferCount = 2;
+	static constexpr int32_t JpgQuality = 92;
+
+	struct ScreenshotSavingThreadData {
+		int w;
+		int h;
+		uint8_t* dataBuffer = nullptr;
+		std::string filename;
+		Format format = Format::Png;
+	};
+private:
+	struct PixelBuffer {
+		unsigned int pbo = 0;
+		GLsync fence = nullptr;
+		size_t capacity = 0;
+		int w = 0;
+		int h = 0;
+		std::string filename;
+		Format format = Format::Png;
+	};
+	std::array<PixelBuffer, PixelBufferCount> buffers;
+	int32_t nextBuffer = 0;
+
+	SDL_mutex* mutex = nullptr;
+	SDL_cond* jobAvailable = nullptr;
+	std::deque<ScreenshotSavingThreadData> jobs;
+	std::vector<SDL_Thread*> workers;
+	bool shutdown = false;
+	// jobs queued or being encoded
+	std::atomic<int32_t> encoding = 0;
+
+	static int worker(void* user) noexcept;
+	// returns false if the gpu isn't done yet & wait is false
+	bool finish(PixelBuffer& buffer, bool wait) noexcept;
+public:
+	OFS_FrameExporter() noexcept {}
+	~OFS_FrameExporter() noexcept { Shutdown(); }
+
+	OFS_FrameExporter(const OFS_FrameExporter&) = delete;
+	OFS_FrameExporter& operator=(const OFS_FrameExporter&) = delete;
+
+	void Init() noexcept;
+	// waits for every pending image to be written
+	void Shutdown() noexcept;
+
+	// queues a readback of the rgb color attachment of framebuffer
+	// only stalls if both pixel buffers are still in flight
+	void Capture(unsigned int framebuffer, int w, int h, const std::string& filename, Format format) noexcept;
+
+	// hands finished readbacks to the workers. call once per frame
+	void Update() noexcept;
+
+	inline bool InFlight() const noexcept {
+		for (auto& buffer : buffers) { if (buffer.fence != nullptr) return true; }
+		return false;
+	}
+	inline bool Busy() const noexcept { return InFlight() || encoding.load() > 0; }
+};
@@ -0,0 +1,72 @@
+#include "OFS_GpuTimer.h"
+
+#include "glad/glad.h"
+#include "imgui.h"
+
+void OFS_GpuTimer::Shutdown() noexcept
+{
+	if (!initialized) return;
+	for (auto& section : slots) {
+		for (auto& slot : section) {
+			glDeleteQueries(2, slot.queries);
+			slot = Slot();
+		}
+	}
+	initialized = false;
+}
+
+void OFS_GpuTimer::NewFrame() noexcept
+{
+	if (!Enabled) return;
+	if (!initialized) {
+		for (auto& section : slots) {
+			for (auto& slot : section) {
+				glGenQueries(2, slot.queries);
+			}
+		}
+		initialized = true;
+	}
+
+	frameSlot = (frameSlot + 1) % Latency;
+	for (int32_t section = 0; section < SectionCount; section++) {
+		// the slot which gets reused this frame was issued Latency frames ago
+		auto& slot = slots[section][frameSlot];
+		if (!slot.pending) continue;
+		slot.pending = false;
+
+		GLint available = 0;
+		glGetQueryObjectiv(slot.queries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available) continue;
+		GLuint64 start = 0, end = 0;
+		glGetQueryObjectui64v(slot.queries[0], GL_QUERY_RESULT, &start);
+		glGetQueryObjectui64v(slot.queries[1], GL_QUERY_RESULT, &end);
+
+		constexpr float Smoothing = 0.1f;
+		float ms = (end - start) / 1000000.f;
+		averageMs[section] += Smoothing * (ms - averageMs[section]);
+	}
+}
+
+void OFS_GpuTimer::Begin(Section section) noexcept
+{
+	if (!Enabled || !initialized) return;
+	auto& slot = slots[section][frameSlot];
+	glQueryCounter(slot.queries[0], GL_TIMESTAMP);
+}
+
+void OFS_GpuTimer::End(Section section) noexcept
+{
+	if (!Enabled || !initialized) return;
+	auto& slot = slots[section][frameSlot];
+	glQueryCounter(slot.queries[1], GL_TIMESTAMP);
+	slot.pending = true;
+}
+
+void OFS_GpuTimer::ShowTimings() const noexcept
+{
+	// the ui pass contains the vr shader so they don't add up
+	ImGui::TextUnformatted("GPU time per frame");
+	for (int32_t section = 0; section < SectionCount; section++) {
+		ImGui::Text("  %s: %.3f ms", SectionNames[section], averageMs[section]);
+	}
+}
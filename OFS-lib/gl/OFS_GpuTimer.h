@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// gpu time spent on sections of a frame measured with timestamp queries
+// results are read a few frames later so that the cpu never waits for the gpu
+class OFS_GpuTimer
+{
+public:
+	enum Section : int32_t {
+		MpvRender,
+		VrShader,
+		Ui,
+		SectionCount
+	};
+	static constexpr const char* SectionNames[SectionCount] = {
+		"mpv render",
+		"VR shader",
+		"UI",
+	};
+	// frames in flight before a result gets read
+	static constexpr int32_t Latency = 4;
+private:
+	struct Slot {
+		unsigned int queries[2] = {};
+		bool pending = false;
+	};
+	std::array<std::array<Slot, Latency>, SectionCount> slots;
+	std::array<float, SectionCount> averageMs = {};
+	int32_t frameSlot = 0;
+	bool initialized = false;
+public:
+	// queries only get issued while enabled
+	bool Enabled = false;
+
+	// has to happen while the gl context is alive
+	void Shutdown() noexcept;
+
+	// collects finished results & moves on to the next slot. call once per frame
+	void NewFrame() noexcept;
+	// a section can be measured once per frame
+	void Begin(Section section) noexcept;
+	void End(Section section) noexcept;
+
+	inline float Milliseconds(Section section) const noexcept { return averageMs[section]; }
+	void ShowTimings() const noexcept;
+};
@@ -3,6 +3,8 @@
 
 #include "glad/glad.h"
 
+#include <cmath>
+
 ShaderBase::ShaderBase(const char* vtx_shader, const char* frag_shader)
 {
 	unsigned int vertex, fragment;
@@ -74,6 +76,14 @@ void VrShader::Zoom(float zoom) noexcept
 	glUniform1f(glGetUniformLocation(program, "zoom"), zoom);
 }
 
+float VrShader::ViewAngle(float zoom) noexcept
+{
+	// has to match hfovDegrees in the fragment shader
+	// the pane spans uv -0.5 to 0.5 which gets scaled by tan(hfov/2) & divided by zoom
+	constexpr float HorizontalFov = 75.f * 3.1415926535f / 180.f;
+	return 2.f * std::atan(0.5f * std::tan(0.5f * HorizontalFov) / zoom);
+}
+
 void VrShader::VideoAspectRatio(float aspect) noexcept {
 	glUniform1f(glGetUniformLocation(program, "video_aspect_ratio"), aspect);
 }
@@ -121,4 +131,54 @@ void LightingShader::LightPos(const float* vec3) noexcept
 
 void LightingShader::ViewPos(const float* vec3) noexcept {
 	glUniform3fv(glGetUniformLocation(program, "viewPos"), 1, vec3);
-}
\ No newline at end of file
+}
+
+void TimelineShader::ProjMtx(const float* mat4) noexcept
+{
+	glUniformMatrix4fv(glGetUniformLocation(program, "ProjMtx"), 1, GL_FALSE, mat4);
+}
+
+void SplineShader::ProjMtx(const float* mat4) noexcept
+{
+	glUniformMatrix4fv(glGetUniformLocation(program, "ProjMtx"), 1, GL_FALSE, mat4);
+}
+
+void SplineShader::Canvas(const float* vec4) noexcept
+{
+	glUniform4fv(glGetUniformLocation(program, "Canvas"), 1, vec4);
+}
+
+void SplineShader::Window(const float* vec2) noexcept
+{
+	glUniform2fv(glGetUniformLocation(program, "Window"), 1, vec2);
+}
+
+void SplineShader::Radius(float radius) noexcept
+{
+	glUniform1f(glGetUniformLocation(program, "Radius"), radius);
+}
+
+void SplineShader::Subdivisions(int32_t subdivisions) noexcept
+{
+	glUniform1i(glGetUniformLocation(program, "Subdivisions"), subdivisions);
+}
+
+void SplineShader::SpeedScale(float scale) noexcept
+{
+	glUniform1f(glGetUniformLocation(program, "SpeedScale"), scale);
+}
+
+void SplineShader::Color(const float* vec4) noexcept
+{
+	glUniform4fv(glGetUniformLocation(program, "Color"), 1, vec4);
+}
+
+void SplineShader::UseGradient(bool use) noexcept
+{
+	glUniform1i(glGetUniformLocation(program, "UseGradient"), use);
+}
+
+void SplineShader::Gradient(int32_t unit) noexcept
+{
+	glUniform1i(glGetUniformLocation(program, "Gradient"), unit);
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 class ShaderBase {
 protected:
 	unsigned int program = 0;
@@ -140,6 +142,9 @@ public:
 	void Zoom(float zoom) noexcept;
 	void VideoAspectRatio(float aspect) noexcept;
 	void AspectRatio(float aspect) noexcept;
+
+	// horizontal angle in radians the pane shows at zoom
+	static float ViewAngle(float zoom) noexcept;
 };
 
 
@@ -211,4 +216,171 @@ public:
 	void ObjectColor(const float* vec4) noexcept;
 	void LightPos(const float* vec3) noexcept;
 	void ViewPos(const float* vec3) noexcept;
-};
\ No newline at end of file
+};
+
+// draws line segments and points as anti-aliased capsules
+// one instance per capsule expanded to a quad in the vertex shader
+class TimelineShader : public ShaderBase
+{
+private:
+	static constexpr const char* vtx_shader = R"(
+		#version 330 core
+		uniform mat4 ProjMtx;
+		layout (location = 0) in vec4 Segment;
+		layout (location = 1) in float Radius;
+		layout (location = 2) in vec4 Color;
+
+		out vec2 Frag_Pos;
+		flat out vec4 Frag_Segment;
+		flat out float Frag_Radius;
+		flat out vec4 Frag_Color;
+
+		void main()
+		{
+			vec2 p1 = Segment.xy;
+			vec2 p2 = Segment.zw;
+			vec2 dir = p2 - p1;
+			float len = length(dir);
+			dir = len > 0.0001 ? dir / len : vec2(1.0, 0.0);
+			vec2 normal = vec2(-dir.y, dir.x);
+
+			// one extra pixel for the anti-aliased edge
+			float extent = Radius + 1.0;
+			float along = (gl_VertexID & 1) == 0 ? -extent : len + extent;
+			float across = (gl_VertexID & 2) == 0 ? -extent : extent;
+			vec2 pos = p1 + dir * along + normal * across;
+
+			Frag_Pos = pos;
+			Frag_Segment = Segment;
+			Frag_Radius = Radius;
+			Frag_Color = Color;
+			gl_Position = ProjMtx * vec4(pos, 0.0, 1.0);
+		}
+	)";
+
+	static constexpr const char* frag_shader = R"(
+		#version 330 core
+		in vec2 Frag_Pos;
+		flat in vec4 Frag_Segment;
+		flat in float Frag_Radius;
+		flat in vec4 Frag_Color;
+
+		out vec4 Out_Color;
+
+		void main()
+		{
+			vec2 pa = Frag_Pos - Frag_Segment.xy;
+			vec2 ba = Frag_Segment.zw - Frag_Segment.xy;
+			float h = clamp(dot(pa, ba) / max(dot(ba, ba), 0.0001), 0.0, 1.0);
+			float dist = length(pa - ba * h);
+			float alpha = clamp(Frag_Radius - dist + 0.5, 0.0, 1.0);
+			if (alpha <= 0.0) discard;
+			Out_Color = vec4(Frag_Color.rgb, Frag_Color.a * alpha);
+		}
+	)";
+public:
+	TimelineShader()
+		: ShaderBase(vtx_shader, frag_shader)
+	{}
+
+	void ProjMtx(const float* mat4) noexcept;
+};
+
+
+// tessellates the catmull-rom segments between actions
+// one instance per segment with the four control points as instance attributes
+// matches the evaluation of FunscriptSpline
+class SplineShader : public ShaderBase
+{
+private:
+	static constexpr const char* vtx_shader = R"(
+		#version 330 core
+		uniform mat4 ProjMtx;
+		uniform vec4 Canvas; // position & size
+		uniform vec2 Window; // offset & visible size in ms
+		uniform float Radius;
+		uniform int Subdivisions;
+		uniform float SpeedScale;
+
+		layout (location = 0) in float At1;
+		layout (location = 1) in float At2;
+		layout (location = 2) in float Pos0;
+		layout (location = 3) in float Pos1;
+		layout (location = 4) in float Pos2;
+		layout (location = 5) in float Pos3;
+
+		out float Frag_Across;
+		flat out float Frag_Speed;
+
+		float catmullRom(float s)
+		{
+			float s2 = s * s;
+			float s3 = s2 * s;
+			float f1 = -s3 + 2.0 * s2 - s;
+			float f2 = 3.0 * s3 - 5.0 * s2 + 2.0;
+			float f3 = -3.0 * s3 + 4.0 * s2 + s;
+			float f4 = s3 - s2;
+			return (f1 * Pos0 + f2 * Pos1 + f3 * Pos2 + f4 * Pos3) * 0.5;
+		}
+
+		vec2 pointAt(float s)
+		{
+			float timeMs = mix(At1, At2, s);
+			float pos = clamp(catmullRom(s), 0.0, 100.0);
+			return Canvas.xy + vec2(((timeMs - Window.x) / Window.y) * Canvas.z, (1.0 - (pos / 100.0)) * Canvas.w);
+		}
+
+		void main()
+		{
+			float s = float(gl_VertexID / 2) / float(Subdivisions);
+			float side = (gl_VertexID & 1) == 0 ? -1.0 : 1.0;
+
+			float eps = 0.5 / float(Subdivisions);
+			vec2 tangent = pointAt(min(s + eps, 1.0)) - pointAt(max(s - eps, 0.0));
+			float len = length(tangent);
+			tangent = len > 0.0001 ? tangent / len : vec2(1.0, 0.0);
+			vec2 normal = vec2(-tangent.y, tangent.x);
+
+			// one extra pixel for the anti-aliased edge
+			float extent = Radius + 1.0;
+			Frag_Across = side * extent;
+			Frag_Speed = clamp((abs(Pos2 - Pos1) / ((At2 - At1) / 1000.0)) * SpeedScale, 0.0, 1.0);
+			gl_Position = ProjMtx * vec4(pointAt(s) + normal * side * extent, 0.0, 1.0);
+		}
+	)";
+
+	static constexpr const char* frag_shader = R"(
+		#version 330 core
+		uniform sampler2D Gradient;
+		uniform vec4 Color;
+		uniform int UseGradient;
+		uniform float Radius;
+
+		in float Frag_Across;
+		flat in float Frag_Speed;
+
+		out vec4 Out_Color;
+
+		void main()
+		{
+			float alpha = clamp(Radius - abs(Frag_Across) + 0.5, 0.0, 1.0);
+			if (alpha <= 0.0) discard;
+			vec4 color = UseGradient != 0 ? texture(Gradient, vec2(Frag_Speed, 0.5)) : Color;
+			Out_Color = vec4(color.rgb, color.a * alpha);
+		}
+	)";
+public:
+	SplineShader()
+		: ShaderBase(vtx_shader, frag_shader)
+	{}
+
+	void ProjMtx(const float* mat4) noexcept;
+	void Canvas(const float* vec4) noexcept;
+	void Window(const float* vec2) noexcept;
+	void Radius(float radius) noexcept;
+	void Subdivisions(int32_t subdivisions) noexcept;
+	void SpeedScale(float scale) noexcept;
+	void Color(const float* vec4) noexcept;
+	void UseGradient(bool use) noexcept;
+	void Gradient(int32_t unit) noexcept;
+};
@@ -0,0 +1,143 @@
+#include "OFS_TimelineLaneCache.h"
+#include "OFS_Util.h"
+
+#include "imgui_internal.h"
+#include "imgui_impl_opengl3.h"
+#include "glad/glad.h"
+
+#include <cmath>
+#include <algorithm>
+
+OFS_TimelineLaneCache::~OFS_TimelineLaneCache() noexcept
+{
+	for (auto& lane : lanes) {
+		freeLane(lane);
+	}
+}
+
+void OFS_TimelineLaneCache::freeLane(Lane& lane) noexcept
+{
+	if (lane.framebuffer != 0) {
+		glDeleteFramebuffers(1, &lane.framebuffer);
+		glDeleteTextures(1, &lane.texture);
+		lane.framebuffer = 0;
+		lane.texture = 0;
+	}
+	if (lane.drawList != nullptr) {
+		IM_DELETE(lane.drawList);
+		lane.drawList = nullptr;
+	}
+	lane.valid = false;
+	lane.pending = false;
+}
+
+void OFS_TimelineLaneCache::Resize(size_t laneCount) noexcept
+{
+	for (size_t i = laneCount; i < lanes.size(); i++) {
+		freeLane(lanes[i]);
+	}
+	lanes.resize(laneCount);
+}
+
+void OFS_TimelineLaneCache::updateFramebuffer(Lane& lane) noexcept
+{
+	auto& io = ImGui::GetIO();
+	int32_t width = std::max(1, (int32_t)std::ceil(lane.drawData.DisplaySize.x * io.DisplayFramebufferScale.x));
+	int32_t height = std::max(1, (int32_t)std::ceil(lane.drawData.DisplaySize.y * io.DisplayFramebufferScale.y));
+	if (lane.framebuffer != 0 && width == lane.texWidth && height == lane.texHeight) return;
+
+	if (lane.framebuffer == 0) {
+		glGenFramebuffers(1, &lane.framebuffer);
+		glGenTextures(1, &lane.texture);
+	}
+	lane.texWidth = width;
+	lane.texHeight = height;
+
+	glBindTexture(GL_TEXTURE_2D, lane.texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+
+	GLint lastFramebuffer; glGetIntegerv(GL_FRAMEBUFFER_BINDING, &lastFramebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, lane.framebuffer);
+	glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, lane.texture, 0);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+		LOG_ERROR("Failed to create framebuffer for timeline lane!");
+	}
+	glBindFramebuffer(GL_FRAMEBUFFER, lastFramebuffer);
+}
+
+ImDrawList* OFS_TimelineLaneCache::Begin(int32_t idx, uint64_t key, const ImVec2& pos, const ImVec2& size) noexcept
+{
+	auto& lane = lanes[idx];
+	// the texture doesn't depend on pos since the lane gets rendered relative to it
+	if (lane.valid && lane.key == key && lane.size.x == size.x && lane.size.y == size.y) {
+		return nullptr;
+	}
+	lane.key = key;
+	lane.size = size;
+	lane.valid = true;
+	lane.pending = true;
+
+	const ImVec2 margin(Margin, Margin);
+	auto& data = lane.drawData;
+	data.Clear();
+	data.Valid = true;
+	data.DisplayPos = pos - margin;
+	data.DisplaySize = size + margin + margin;
+	data.FramebufferScale = ImGui::GetIO().DisplayFramebufferScale;
+	updateFramebuffer(lane);
+
+	// the list keeps its buffers between recordings
+	if (lane.drawList == nullptr) { lane.drawList = IM_NEW(ImDrawList)(ImGui::GetDrawListSharedData()); }
+	lane.drawList->_ResetForNewFrame();
+	lane.drawList->Flags = ImGui::GetWindowDrawList()->Flags;
+	lane.drawList->PushTextureID(ImGui::GetIO().Fonts->TexID);
+	lane.drawList->PushClipRect(data.DisplayPos, data.DisplayPos + data.DisplaySize);
+	AddLaneBlend(lane.drawList);
+	return lane.drawList;
+}
+
+void OFS_TimelineLaneCache::AddLaneBlend(ImDrawList* draw_list) noexcept
+{
+	// blending the alpha like the color would leave the texture translucent where it's covered
+	// this keeps it premultiplied without touching the blend state of the imgui backend
+	draw_list->AddCallback([](const ImDrawList* parent_list, const ImDrawCmd* cmd) {
+		glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+	}, nullptr);
+}
+
+void OFS_TimelineLaneCache::Composite(int32_t idx, ImDrawList* draw_list, const ImVec2& pos) noexcept
+{
+	auto& lane = lanes[idx];
+	if (!lane.valid) return;
+	// the texture holds premultiplied alpha
+	draw_list->AddCallback([](const ImDrawList* parent_list, const ImDrawCmd* cmd) { glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); }, nullptr);
+	// the texture is upside down
+	const ImVec2 margin(Margin, Margin);
+	draw_list->AddImage((void*)(intptr_t)lane.texture, pos - margin, pos + lane.size + margin, ImVec2(0.f, 1.f), ImVec2(1.f, 0.f));
+	draw_list->AddCallback(ImDrawCallback_ResetRenderState, nullptr);
+}
+
+void OFS_TimelineLaneCache::Render() noexcept
+{
+	GLint lastFramebuffer = -1;
+	for (auto& lane : lanes) {
+		if (!lane.pending) continue;
+		lane.pending = false;
+
+		if (lastFramebuffer < 0) { glGetIntegerv(GL_FRAMEBUFFER_BINDING, &lastFramebuffer); }
+		// lanes move around when the vector grows
+		lane.drawData.CmdLists = &lane.drawList;
+		lane.drawData.CmdListsCount = 1;
+		lane.drawData.TotalVtxCount = lane.drawList->VtxBuffer.Size;
+		lane.drawData.TotalIdxCount = lane.drawList->IdxBuffer.Size;
+		glBindFramebuffer(GL_FRAMEBUFFER, lane.framebuffer);
+		glClearColor(0.f, 0.f, 0.f, 0.f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		ImGui_ImplOpenGL3_RenderDrawData(&lane.drawData);
+	}
+	if (lastFramebuffer >= 0) {
+		glBindFramebuffer(GL_FRAMEBUFFER, lastFramebuffer);
+	}
+}
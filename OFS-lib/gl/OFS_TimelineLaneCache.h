@@ -0,0 +1,88 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include "imgui.h"
+
+// retained rendering of the script timeline lanes
+// a lane gets recorded into its own draw list & rendered into a framebuffer
+// as long as its content key doesn't change only the cached texture gets composited
+class OFS_TimelineLaneCache
+{
+public:
+	// fnv-1a over everything the content of a lane depends on
+	class ContentKey {
+		uint64_t hash = 0xcbf29ce484222325ULL;
+	public:
+		template<typename T>
+		inline ContentKey& Add(const T& value) noexcept {
+			return AddBytes(&value, sizeof(T));
+		}
+		inline ContentKey& Add(const std::string& str) noexcept {
+			return AddBytes(str.data(), str.size());
+		}
+		inline ContentKey& AddBytes(const void* data, size_t size) noexcept {
+			auto bytes = (const uint8_t*)data;
+			for (size_t i = 0; i < size; i++) {
+				hash ^= bytes[i];
+				hash *= 0x100000001b3ULL;
+			}
+			return *this;
+		}
+		inline uint64_t Value() const noexcept { return hash; }
+	};
+private:
+	// points & thick lines reach over the edges of a lane
+	static constexpr float Margin = 8.f;
+
+	struct Lane {
+		uint64_t key = 0;
+		unsigned int framebuffer = 0;
+		unsigned int texture = 0;
+		int32_t texWidth = 0;
+		int32_t texHeight = 0;
+		// size of the lane without the margin
+		ImVec2 size;
+		ImDrawList* drawList = nullptr;
+		ImDrawData drawData;
+		// has a valid texture
+		bool valid = false;
+		// got recorded this frame & still has to be rendered
+		bool pending = false;
+	};
+	std::vector<Lane> lanes;
+
+	void freeLane(Lane& lane) noexcept;
+	void updateFramebuffer(Lane& lane) noexcept;
+public:
+	OFS_TimelineLaneCache() noexcept {}
+	~OFS_TimelineLaneCache() noexcept;
+
+	OFS_TimelineLaneCache(const OFS_TimelineLaneCache&) = delete;
+	OFS_TimelineLaneCache& operator=(const OFS_TimelineLaneCache&) = delete;
+
+	// lanes are indexed by script
+	void Resize(size_t laneCount) noexcept;
+
+	// returns the draw list to record the lane into
+	// nullptr if the cached texture is still up to date
+	ImDrawList* Begin(int32_t idx, uint64_t key, const ImVec2& pos, const ImVec2& size) noexcept;
+
+	// sets the blend state of a lane at the current position of draw_list
+	// has to follow every ImDrawCallback_ResetRenderState recorded into a lane
+	static void AddLaneBlend(ImDrawList* draw_list) noexcept;
+
+	// the draw data the lane gets rendered with
+	inline const ImDrawData* Target(int32_t idx) const noexcept { return &lanes[idx].drawData; }
+
+	// draws the cached texture of the lane at pos into draw_list
+	void Composite(int32_t idx, ImDrawList* draw_list, const ImVec2& pos) noexcept;
+
+	// renders every lane recorded during this frame into its framebuffer
+	// has to be called after ImGui::Render & before the imgui draw data gets rendered
+	void Render() noexcept;
+
+	inline void Invalidate() noexcept { for (auto& lane : lanes) { lane.valid = false; } }
+};
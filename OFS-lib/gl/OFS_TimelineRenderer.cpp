@@ -0,0 +1,253 @@
+#include "OFS_TimelineRenderer.h"
+#include "OFS_TimelineLaneCache.h"
+
+#include "glad/glad.h"
+
+OFS_TimelineRenderer::~OFS_TimelineRenderer() noexcept
+{
+	if (VAO != 0) {
+		glDeleteVertexArrays(1, &VAO);
+		glDeleteVertexArrays(1, &splineVAO);
+		glDeleteBuffers(1, &VBO);
+	}
+	if (gradientTexture != 0) {
+		glDeleteTextures(1, &gradientTexture);
+	}
+	for (auto& [key, buffer] : actionBuffers) {
+		glDeleteBuffers(1, &buffer.VBO);
+	}
+}
+
+void OFS_TimelineRenderer::setup() noexcept
+{
+	shader = std::make_unique<TimelineShader>();
+	splineShader = std::make_unique<SplineShader>();
+
+	glGenVertexArrays(1, &VAO);
+	glGenBuffers(1, &VBO);
+
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glEnableVertexAttribArray(0);
+	glEnableVertexAttribArray(1);
+	glEnableVertexAttribArray(2);
+	// every capsule is one instance of a 4 vertex triangle strip
+	glVertexAttribDivisor(0, 1);
+	glVertexAttribDivisor(1, 1);
+	glVertexAttribDivisor(2, 1);
+
+	// every spline segment is one instance of a triangle strip along the curve
+	glGenVertexArrays(1, &splineVAO);
+	glBindVertexArray(splineVAO);
+	for (int i = 0; i < 6; i++) {
+		glEnableVertexAttribArray(i);
+		glVertexAttribDivisor(i, 1);
+	}
+	glBindVertexArray(0);
+}
+
+void OFS_TimelineRenderer::upload() noexcept
+{
+	if (VAO == 0) { setup(); }
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, capsules.size() * sizeof(Capsule), capsules.data(), GL_STREAM_DRAW);
+
+	if (gradientTexture == 0 && speedGradient != nullptr) {
+		constexpr int32_t GradientWidth = 256;
+		uint32_t pixels[GradientWidth];
+		speedGradient->rasterize(pixels, GradientWidth);
+
+		glGenTextures(1, &gradientTexture);
+		glBindTexture(GL_TEXTURE_2D, gradientTexture);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, GradientWidth, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+	}
+	uploaded = true;
+}
+
+const OFS_TimelineRenderer::ActionBuffer* OFS_TimelineRenderer::actionBuffer(const std::vector<FunscriptAction>& actions, uint32_t version) noexcept
+{
+	if (VAO == 0) { setup(); }
+
+	// the vector is the key since it lives as long as its script
+	auto& buffer = actionBuffers[&actions];
+	buffer.used = true;
+	if (buffer.VBO != 0 && buffer.version == version) {
+		return &buffer;
+	}
+
+	padded.clear();
+	padded.reserve(actions.size() + 2);
+	padded.emplace_back(actions.front());
+	padded.insert(padded.end(), actions.begin(), actions.end());
+	padded.emplace_back(actions.back());
+
+	if (buffer.VBO == 0) { glGenBuffers(1, &buffer.VBO); }
+	glBindBuffer(GL_ARRAY_BUFFER, buffer.VBO);
+	glBufferData(GL_ARRAY_BUFFER, padded.size() * sizeof(FunscriptAction), padded.data(), GL_STATIC_DRAW);
+	buffer.version = version;
+	return &buffer;
+}
+
+void OFS_TimelineRenderer::NewFrame() noexcept
+{
+	capsules.clear();
+	overlayCapsules.clear();
+	splines.clear();
+	batchCount = 0;
+	flushedCount = 0;
+	flushedSplines = 0;
+	uploaded = false;
+
+	// drop the buffers of scripts which weren't drawn last frame
+	for (auto it = actionBuffers.begin(); it != actionBuffers.end();) {
+		if (!it->second.used) {
+			glDeleteBuffers(1, &it->second.VBO);
+			it = actionBuffers.erase(it);
+		}
+		else {
+			it->second.used = false;
+			++it;
+		}
+	}
+}
+
+void OFS_TimelineRenderer::addSpline(const std::vector<FunscriptAction>& actions, uint32_t version, int32_t fromIdx, int32_t toIdx,
+	const SplineWindow& window, float thickness, uint32_t color, float speedScale) noexcept
+{
+	if (actions.size() < 2 || toIdx <= fromIdx) return;
+
+	SplineDraw draw;
+	draw.buffer = actionBuffer(actions, version);
+	draw.window = window;
+	draw.firstSegment = fromIdx;
+	draw.segmentCount = toIdx - fromIdx;
+	draw.radius = thickness * 0.5f;
+	draw.color = color;
+	draw.speedScale = speedScale;
+	splines.emplace_back(draw);
+}
+
+void OFS_TimelineRenderer::Flush(ImDrawList* draw_list) noexcept
+{
+	if (flushedCount == capsules.size() && flushedSplines == splines.size()) return;
+
+	if (batchCount == batches.size()) {
+		batches.emplace_back(std::make_unique<Batch>());
+	}
+	auto& batch = *batches[batchCount++];
+	batch.renderer = this;
+	batch.viewport = ImGui::GetWindowViewport();
+	batch.drawData = target;
+	batch.first = flushedCount;
+	batch.count = (uint32_t)capsules.size() - flushedCount;
+	batch.firstSpline = flushedSplines;
+	batch.splineCount = (uint32_t)splines.size() - flushedSplines;
+	flushedCount = (uint32_t)capsules.size();
+	flushedSplines = (uint32_t)splines.size();
+
+	draw_list->AddCallback(
+		[](const ImDrawList* parent_list, const ImDrawCmd* cmd) {
+			auto& batch = *(Batch*)cmd->UserCallbackData;
+			batch.renderer->drawBatch(batch, cmd);
+		}, &batch);
+	draw_list->AddCallback(ImDrawCallback_ResetRenderState, nullptr);
+	// the reset puts back the blend state of the backend which a cached lane doesn't use
+	if (target != nullptr) { OFS_TimelineLaneCache::AddLaneBlend(draw_list); }
+}
+
+void OFS_TimelineRenderer::FlushOverlay(ImDrawList* draw_list) noexcept
+{
+	Flush(draw_list);
+	capsules.insert(capsules.end(), overlayCapsules.begin(), overlayCapsules.end());
+	overlayCapsules.clear();
+	Flush(draw_list);
+}
+
+void OFS_TimelineRenderer::drawBatch(const Batch& batch, const ImDrawCmd* cmd) noexcept
+{
+	// the first batch of a frame uploads everything
+	if (!uploaded) { upload(); }
+
+	auto draw_data = batch.drawData != nullptr ? batch.drawData : batch.viewport->DrawData;
+	float L = draw_data->DisplayPos.x;
+	float R = draw_data->DisplayPos.x + draw_data->DisplaySize.x;
+	float T = draw_data->DisplayPos.y;
+	float B = draw_data->DisplayPos.y + draw_data->DisplaySize.y;
+	const float ortho_projection[4][4] =
+	{
+		{ 2.0f / (R - L), 0.0f, 0.0f, 0.0f },
+		{ 0.0f, 2.0f / (T - B), 0.0f, 0.0f },
+		{ 0.0f, 0.0f, -1.0f, 0.0f },
+		{ (R + L) / (L - R),  (T + B) / (B - T),  0.0f,   1.0f },
+	};
+
+	// callbacks don't get a scissor from the imgui backend
+	ImVec2 clip_off = draw_data->DisplayPos;
+	ImVec2 clip_scale = draw_data->FramebufferScale;
+	float fb_height = draw_data->DisplaySize.y * clip_scale.y;
+	ImVec4 clip_rect(
+		(cmd->ClipRect.x - clip_off.x) * clip_scale.x,
+		(cmd->ClipRect.y - clip_off.y) * clip_scale.y,
+		(cmd->ClipRect.z - clip_off.x) * clip_scale.x,
+		(cmd->ClipRect.w - clip_off.y) * clip_scale.y
+	);
+	glScissor((int)clip_rect.x, (int)(fb_height - clip_rect.w), (int)(clip_rect.z - clip_rect.x), (int)(clip_rect.w - clip_rect.y));
+
+	if (batch.count > 0) {
+		shader->use();
+		shader->ProjMtx(&ortho_projection[0][0]);
+
+		// gl 3.3 has no base instance so the attributes start at the first capsule of the batch
+		glBindVertexArray(VAO);
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		const size_t offset = batch.first * sizeof(Capsule);
+		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Capsule), (void*)(offset + offsetof(Capsule, p1)));
+		glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, sizeof(Capsule), (void*)(offset + offsetof(Capsule, radius)));
+		glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Capsule), (void*)(offset + offsetof(Capsule, color)));
+		glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, batch.count);
+	}
+
+	if (batch.splineCount > 0) {
+		drawSplines(batch, &ortho_projection[0][0]);
+	}
+}
+
+void OFS_TimelineRenderer::drawSplines(const Batch& batch, const float* projection) noexcept
+{
+	splineShader->use();
+	splineShader->ProjMtx(projection);
+	splineShader->Subdivisions(SplineSubdivisions);
+	splineShader->Gradient(0);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, gradientTexture);
+	glBindVertexArray(splineVAO);
+
+	constexpr size_t stride = sizeof(FunscriptAction);
+	for (uint32_t i = batch.firstSpline; i < batch.firstSpline + batch.splineCount; i++) {
+		auto& draw = splines[i];
+
+		const float canvas[4] = { draw.window.canvasPos.x, draw.window.canvasPos.y, draw.window.canvasSize.x, draw.window.canvasSize.y };
+		const float window[2] = { draw.window.offsetMs, draw.window.visibleSizeMs };
+		splineShader->Canvas(canvas);
+		splineShader->Window(window);
+		splineShader->Radius(draw.radius);
+		splineShader->SpeedScale(draw.speedScale);
+		splineShader->UseGradient(draw.speedScale > 0.f);
+		auto color = ImGui::ColorConvertU32ToFloat4(draw.color);
+		splineShader->Color(&color.x);
+
+		// segment i reads the padded actions i to i+3
+		glBindBuffer(GL_ARRAY_BUFFER, draw.buffer->VBO);
+		const size_t offset = draw.firstSegment * stride;
+		glVertexAttribPointer(0, 1, GL_INT, GL_FALSE, stride, (void*)(offset + 1 * stride + offsetof(FunscriptAction, at)));
+		glVertexAttribPointer(1, 1, GL_INT, GL_FALSE, stride, (void*)(offset + 2 * stride + offsetof(FunscriptAction, at)));
+		for (int j = 0; j < 4; j++) {
+			glVertexAttribPointer(2 + j, 1, GL_SHORT, GL_FALSE, stride, (void*)(offset + j * stride + offsetof(FunscriptAction, pos)));
+		}
+		glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 2 * (SplineSubdivisions + 1), draw.segmentCount);
+	}
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+#include "OFS_Shader.h"
+#include "FunscriptAction.h"
+#include "GradientBar.h"
+
+#include "imgui.h"
+
+// batches the lines & points of the script timeline
+// everything added during a frame gets uploaded once as an instance buffer
+// and drawn with one instanced draw call per Flush from an imgui draw callback
+// splines are tessellated on the gpu from the actions of the script
+class OFS_TimelineRenderer
+{
+public:
+	// a point is a capsule with p1 == p2
+	struct Capsule {
+		ImVec2 p1;
+		ImVec2 p2;
+		float radius;
+		uint32_t color;
+	};
+
+	// maps the time of the actions to the canvas
+	struct SplineWindow {
+		ImVec2 canvasPos;
+		ImVec2 canvasSize;
+		float offsetMs;
+		float visibleSizeMs;
+	};
+
+	// line segments per spline segment
+	static constexpr int32_t SplineSubdivisions = 32;
+private:
+	// the actions of a script padded with the first & last action
+	// so that every segment can read four control points
+	struct ActionBuffer {
+		unsigned int VBO = 0;
+		uint32_t version = 0;
+		bool used = false;
+	};
+
+	struct SplineDraw {
+		const ActionBuffer* buffer;
+		SplineWindow window;
+		int32_t firstSegment;
+		int32_t segmentCount;
+		float radius;
+		uint32_t color;
+		// 0 for a fixed color
+		float speedScale;
+	};
+
+	struct Batch {
+		OFS_TimelineRenderer* renderer = nullptr;
+		ImGuiViewport* viewport = nullptr;
+		// draw data of the viewport if null
+		const ImDrawData* drawData = nullptr;
+		uint32_t first = 0;
+		uint32_t count = 0;
+		uint32_t firstSpline = 0;
+		uint32_t splineCount = 0;
+	};
+
+	std::unique_ptr<TimelineShader> shader;
+	std::unique_ptr<SplineShader> splineShader;
+	unsigned int VAO = 0;
+	unsigned int VBO = 0;
+	unsigned int splineVAO = 0;
+
+	const ImDrawData* target = nullptr;
+
+	const ImGradient* speedGradient = nullptr;
+	unsigned int gradientTexture = 0;
+
+	std::vector<Capsule> capsules;
+	// drawn on top of everything else by FlushOverlay
+	std::vector<Capsule> overlayCapsules;
+	std::vector<SplineDraw> splines;
+	std::unordered_map<const void*, ActionBuffer> actionBuffers;
+	std::vector<FunscriptAction> padded;
+
+	// batches get referenced by the draw callbacks so their addresses have to stay stable
+	std::vector<std::unique_ptr<Batch>> batches;
+	size_t batchCount = 0;
+	uint32_t flushedCount = 0;
+	uint32_t flushedSplines = 0;
+	bool uploaded = false;
+
+	void setup() noexcept;
+	void upload() noexcept;
+	const ActionBuffer* actionBuffer(const std::vector<FunscriptAction>& actions, uint32_t version) noexcept;
+	void addSpline(const std::vector<FunscriptAction>& actions, uint32_t version, int32_t fromIdx, int32_t toIdx,
+		const SplineWindow& window, float thickness, uint32_t color, float speedScale) noexcept;
+	void drawBatch(const Batch& batch, const ImDrawCmd* cmd) noexcept;
+	void drawSplines(const Batch& batch, const float* projection) noexcept;
+public:
+	OFS_TimelineRenderer() noexcept {}
+	~OFS_TimelineRenderer() noexcept;
+
+	OFS_TimelineRenderer(const OFS_TimelineRenderer&) = delete;
+	OFS_TimelineRenderer& operator=(const OFS_TimelineRenderer&) = delete;
+
+	// call once per frame before adding anything
+	void NewFrame() noexcept;
+
+	inline void AddLine(const ImVec2& p1, const ImVec2& p2, uint32_t color, float thickness) noexcept {
+		capsules.emplace_back(Capsule{ p1, p2, thickness * 0.5f, color });
+	}
+	inline void AddPoint(const ImVec2& p, float radius, uint32_t color) noexcept {
+		capsules.emplace_back(Capsule{ p, p, radius, color });
+	}
+	inline void AddOverlayPoint(const ImVec2& p, float radius, uint32_t color) noexcept {
+		overlayCapsules.emplace_back(Capsule{ p, p, radius, color });
+	}
+
+	// gradient used to color splines by speed. rasterized on first use
+	inline void SetSpeedGradient(const ImGradient* gradient) noexcept { speedGradient = gradient; }
+
+	// the spline through the actions from fromIdx to toIdx (inclusive)
+	// version has to change whenever the actions change
+	inline void AddSpline(const std::vector<FunscriptAction>& actions, uint32_t version, int32_t fromIdx, int32_t toIdx,
+		const SplineWindow& window, float thickness, uint32_t color) noexcept {
+		addSpline(actions, version, fromIdx, toIdx, window, thickness, color, 0.f);
+	}
+	// same as AddSpline but every segment is colored by its speed relative to maxSpeedPerSecond
+	inline void AddSpeedSpline(const std::vector<FunscriptAction>& actions, uint32_t version, int32_t fromIdx, int32_t toIdx,
+		const SplineWindow& window, float thickness, float maxSpeedPerSecond) noexcept {
+		addSpline(actions, version, fromIdx, toIdx, window, thickness, 0, 1.f / maxSpeedPerSecond);
+	}
+
+	// draw data which following Flushes get rendered with
+	// null for the draw data of the current viewport
+	inline void SetTarget(const ImDrawData* drawData) noexcept { target = drawData; }
+
+	// draws everything added since the last Flush at the current position of draw_list
+	// splines are drawn after the lines & points of the same Flush
+	void Flush(ImDrawList* draw_list) noexcept;
+	// draws the overlay points added during this frame
+	void FlushOverlay(ImDrawList* draw_list) noexcept;
+
+	inline size_t CapsuleCount() const noexcept { return capsules.size(); }
+};
@@ -0,0 +1,82 @@
+#include "OFS_PlaybackClock.h"
+
+#include <cmath>
+#include <algorithm>
+
+void OFS_PlaybackClock::publish(double position, int64_t timeNs, double newRate, bool discontinuity) noexcept
+{
+	uint32_t seq = sequence.load(std::memory_order_relaxed);
+	sequence.store(seq + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	basePosition.store(position, std::memory_order_relaxed);
+	baseTimeNs.store(timeNs, std::memory_order_relaxed);
+	rate.store(newRate, std::memory_order_relaxed);
+	if (discontinuity) {
+		epoch.store(epoch.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+	sequence.store(seq + 2, std::memory_order_release);
+}
+
+OFS_PlaybackClock::Sample OFS_PlaybackClock::Get(int64_t timeNs) const noexcept
+{
+	Sample sample;
+	uint32_t before, after;
+	double position, currentRate;
+	int64_t baseNs;
+	do {
+		before = sequence.load(std::memory_order_acquire);
+		position = basePosition.load(std::memory_order_relaxed);
+		baseNs = baseTimeNs.load(std::memory_order_relaxed);
+		currentRate = rate.load(std::memory_order_relaxed);
+		sample.epoch = epoch.load(std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		after = sequence.load(std::memory_order_relaxed);
+	} while ((before & 1) || before != after);
+
+	sample.position = position + (double)(timeNs - baseNs) * 1e-9 * currentRate;
+	return sample;
+}
+
+void OFS_PlaybackClock::Observe(double position, int64_t timeNs) noexcept
+{
+	if (paused) {
+		Reset(position);
+		return;
+	}
+
+	const double predicted = Position(timeNs);
+	const double error = position - predicted;
+	lastError = error;
+	if (std::abs(error) > SnapThreshold) {
+		rateCorrection = 0.0;
+		publish(position, timeNs, nominalRate(), true);
+		return;
+	}
+
+	// integral part: a persistent error means the wall clock & mpv run at slightly different rates
+	rateCorrection = std::clamp(rateCorrection + RateGain * error, -MaxRateCorrection, MaxRateCorrection);
+	// proportional part: absorb the error over SlewSeconds without jumping
+	double phaseRate = std::clamp(error / SlewSeconds, -MaxSlewRate * speed, MaxSlewRate * speed);
+	publish(predicted, timeNs, nominalRate() + phaseRate, false);
+}
+
+void OFS_PlaybackClock::Reset(double position) noexcept
+{
+	lastError = 0.0;
+	publish(position, Now(), nominalRate(), true);
+}
+
+void OFS_PlaybackClock::SetPaused(bool paused, double position) noexcept
+{
+	this->paused = paused;
+	Reset(position);
+}
+
+void OFS_PlaybackClock::SetSpeed(double speed) noexcept
+{
+	// continue from where the clock is right now
+	auto now = Now();
+	double position = Position(now);
+	this->speed = speed;
+	publish(position, now, nominalRate(), false);
+}
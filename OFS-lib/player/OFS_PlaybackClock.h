@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// the one playback position every consumer reads. gui, simulators & the t-code thread
+// mpv reports the position in irregular steps, in between it gets extrapolated.
+// a phase locked loop slews the rate towards the reported positions instead of jumping
+// & tracks the rate error between the wall clock & mpv's audio clock
+class OFS_PlaybackClock
+{
+public:
+	// errors above this are a discontinuity like a seek & reset the loop
+	static constexpr double SnapThreshold = 0.1;
+	// phase errors get absorbed over this many seconds
+	static constexpr double SlewSeconds = 0.25;
+	// limits how much faster or slower than the playback speed the clock slews
+	static constexpr double MaxSlewRate = 0.1;
+	// integral gain of the rate correction per observation
+	static constexpr double RateGain = 0.02;
+	static constexpr double MaxRateCorrection = 0.02;
+
+	struct Sample {
+		double position = 0.0;
+		// increments on every discontinuity
+		uint32_t epoch = 0;
+	};
+
+	static inline int64_t Now() noexcept {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+private:
+	// published state, written by the main thread only
+	// readers retry while sequence is odd or changed in between
+	std::atomic<uint32_t> sequence = 0;
+	std::atomic<double> basePosition = 0.0;
+	std::atomic<int64_t> baseTimeNs = 0;
+	std::atomic<double> rate = 0.0;
+	std::atomic<uint32_t> epoch = 0;
+
+	// loop state. main thread only
+	double speed = 1.0;
+	bool paused = true;
+	double rateCorrection = 0.0;
+	double lastError = 0.0;
+
+	void publish(double position, int64_t timeNs, double newRate, bool discontinuity) noexcept;
+	inline double nominalRate() const noexcept { return paused ? 0.0 : speed * (1.0 + rateCorrection); }
+public:
+	// the position mpv reported at timeNs
+	void Observe(double position, int64_t timeNs = Now()) noexcept;
+	// seeks & file changes
+	void Reset(double position) noexcept;
+	void SetPaused(bool paused, double position) noexcept;
+	void SetSpeed(double speed) noexcept;
+
+	// lock-free. can be called from any thread
+	Sample Get(int64_t timeNs = Now()) const noexcept;
+	inline double Position(int64_t timeNs = Now()) const noexcept { return Get(timeNs).position; }
+
+	// seconds between the last reported position & the extrapolated one
+	inline double LastError() const noexcept { return lastError; }
+	inline double RateCorrection() const noexcept { return rateCorrection; }
+};
@@ -157,10 +157,8 @@ void TCodePlayer::save() noexcept
 static struct TCodeThreadData {
     volatile bool requestStop = false;
     bool running = false;
-    
-    SDL_atomic_t scriptTimeMs = { 0 };
-    
-    volatile float speed = 1.f;
+
+    const OFS_PlaybackClock* clock = nullptr;
 
     TCodePlayer* player = nullptr;
     TCodeChannels* channel = nullptr;
@@ -382,32 +380,23 @@ static int32_t TCodeThread(void* threadData) noexcept {
     TCodeThreadData* data = (TCodeThreadData*)threadData;
 
     LOG_INFO("T-Code thread started...");
-    auto startTime = std::chrono::high_resolution_clock::now();
-    
-    int scriptTimeMs = 0;
 
-    data->producer->sync(SDL_AtomicGet(&data->scriptTimeMs), data->player->tickrate);
+    auto sample = data->clock->Get();
+    uint32_t epoch = sample.epoch;
+    data->producer->sync(std::round(sample.position * 1000.0) - data->player->delay, data->player->tickrate);
 
     while (!data->requestStop) {
         float tickrate = data->player->tickrate;
         float tickDurationSeconds = 1.f / tickrate;
         auto currentTime = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<float> duration;
 
         int32_t delay = data->player->delay;
-        int32_t data_scriptTimeMs = SDL_AtomicGet(&data->scriptTimeMs);
-        
-        std::chrono::duration<float> duration = currentTime - startTime;
-
-        int32_t currentTimeMs = (((duration.count()*1000.f) * data->speed) + scriptTimeMs) - delay;
-        int32_t syncTimeMs =  data_scriptTimeMs - delay;
-        if (std::abs(currentTimeMs - syncTimeMs) >= 60) {
-            LOGF_INFO("Resync -> %d", currentTimeMs - syncTimeMs);
-            LOGF_INFO("prev: %d new: %d", currentTimeMs, syncTimeMs);
-
-            scriptTimeMs = data_scriptTimeMs;
-            startTime = std::move(currentTime);
-            currentTimeMs = syncTimeMs;
-
+        sample = data->clock->Get();
+        int32_t currentTimeMs = std::round(sample.position * 1000.0) - delay;
+        if (sample.epoch != epoch) {
+            // seeked or paused
+            epoch = sample.epoch;
             data->producer->sync(currentTimeMs, tickrate);
         }
         else {
@@ -474,13 +463,13 @@ void TCodePlayer::setScripts(std::vector<std::weak_ptr<const Funscript>>&& scrip
     prod.SetChannels(&tcode);
 }
 
-void TCodePlayer::play(float currentTimeMs, std::vector<std::weak_ptr<const Funscript>> scripts) noexcept
+void TCodePlayer::play(const OFS_PlaybackClock* clock, std::vector<std::weak_ptr<const Funscript>> scripts) noexcept
 {
     if (!Thread.running) {
         Thread.running = true;
         Thread.player = this;
         Thread.channel = &this->tcode;
-        SDL_AtomicSet(&Thread.scriptTimeMs, std::round(currentTimeMs));
+        Thread.clock = clock;
         Thread.producer = &this->prod;
         tcode.reset();
         
@@ -499,10 +488,9 @@ void TCodePlayer::stop() noexcept
     }
 }
 
-void TCodePlayer::sync(float currentTimeMs, float speed) noexcept
+bool TCodePlayer::IsRunning() const noexcept
 {
-    Thread.speed = speed;
-    SDL_AtomicSet(&Thread.scriptTimeMs, std::round(currentTimeMs));
+    return Thread.running;
 }
 
 void TCodePlayer::reset() noexcept
@@ -2,6 +2,7 @@
 #include <cstdint>
 
 #include "OFS_TCodeProducer.h"
+#include "OFS_PlaybackClock.h"
 #include "OFS_Util.h"
 #include "FunscriptAction.h"
 
@@ -32,10 +33,11 @@ public:
 	void DrawWindow(bool* open, float currentTimeMs) noexcept;
 
 	void setScripts(std::vector<std::weak_ptr<const Funscript>>&& scripts) noexcept;
-	void play(float currentTimeMs, std::vector<std::weak_ptr<const Funscript>> scripts) noexcept;
+	// the t-code thread samples clock on every tick
+	void play(const OFS_PlaybackClock* clock, std::vector<std::weak_ptr<const Funscript>> scripts) noexcept;
 	void stop() noexcept;
-	void sync(float currentTimeMs, float speed) noexcept;
 	void reset() noexcept;
+	bool IsRunning() const noexcept;
 
 	template <class Archive>
 	inline void reflect(Archive& ar) {
@@ -0,0 +1,71 @@
+-- same work as bench_table_api.lua but using the ffi action buffers
+-- only available when OFS was built with LuaJIT (OFS_LUAJIT).
+-- the script doesn't modify CurrentScript. compare the timings printed to the console.
+
+if not jit then
+    print("skipped: " .. _VERSION .. " has no ffi. build OFS with OFS_LUAJIT=ON")
+    return
+end
+
+local ffi = require("ffi")
+print("backend: " .. jit.version)
+
+local iterations = 10
+
+local function easeInOutCubic(start_val, end_val, x)
+    if x < 0.5 then
+        x = 4 * x * x * x
+    else
+        x = 1-((-2 * x + 2)^3) / 2
+    end
+    return lerp(start_val, end_val, x)
+end
+
+local buffer, count = CurrentScript:ReadBuffer()
+
+-- easing over every action of the current script
+local startTime = os.clock()
+local generated = 0
+for n=1, iterations do
+    -- count the output first so that it can be written into a single allocation
+    local total = 0
+    for idx=1, count-1 do
+        local point_count = round((buffer[idx].at - buffer[idx-1].at) / 100) - 1
+        if point_count > 0 then total = total + point_count end
+    end
+    local out = ffi.new("OFS_Action[?]", total)
+    local outIdx = 0
+    for idx=1, count-1 do
+        local previous_action = buffer[idx-1]
+        local action = buffer[idx]
+        local point_count = round((action.at - previous_action.at) / 100) - 1
+        for i=1, point_count do
+            local progress = i/(point_count+1)
+            out[outIdx].at = round(previous_action.at + i*100)
+            out[outIdx].pos = easeInOutCubic(previous_action.pos, action.pos, progress)
+            outIdx = outIdx + 1
+        end
+    end
+    generated = generated + outIdx
+    SetProgress(n / (iterations*2))
+end
+print(string.format("easing: %d actions in %.1f ms", generated, (os.clock() - startTime) * 1000.0))
+
+-- one hour sine wave with a point every frame
+local frameTime = FrameTimeMs > 0 and FrameTimeMs or (1000.0/60.0)
+startTime = os.clock()
+generated = 0
+for n=1, iterations do
+    local total = math.floor(60*60*1000 / frameTime) + 1
+    local out = ffi.new("OFS_Action[?]", total)
+    local outIdx = 0
+    for ms=0, 60*60*1000, frameTime do
+        if outIdx >= total then break end
+        out[outIdx].at = round(ms)
+        out[outIdx].pos = round(0.5*(1.0 + math.sin(2.0 * math.pi * 0.75 * (ms/1000.0))) * 100.0)
+        outIdx = outIdx + 1
+    end
+    generated = generated + outIdx
+    SetProgress(0.5 + n / (iterations*2))
+end
+print(string.format("wave: %d actions in %.1f ms", generated, (os.clock() - startTime) * 1000.0))
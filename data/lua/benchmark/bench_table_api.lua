@@ -0,0 +1,56 @@
+-- benchmark for the table based api in funscript.lua
+-- copy this file into the script directory and run it once with each lua backend.
+-- the script doesn't modify CurrentScript. compare the timings printed to the console.
+
+local backend = jit and jit.version or _VERSION
+print("backend: " .. backend)
+
+local iterations = 10
+
+-- easing over every action of the current script
+-- same loop as add_easing_to_selection.lua
+function easeInOutCubic(start_val, end_val, x)
+    if x < 0.5 then
+        x = 4 * x * x * x
+    else
+        x = 1-((-2 * x + 2)^3) / 2
+    end
+    return lerp(start_val, end_val, x)
+end
+
+local startTime = os.clock()
+local generated = 0
+for n=1, iterations do
+    local TmpScript = Funscript:new()
+    local previous_action = nil
+    for idx, action in ipairs(CurrentScript.actions) do
+        if previous_action then
+            local duration = action.at - previous_action.at
+            local point_count = round(duration / 100) - 1
+            for i=1, point_count do
+                local progress = i/(point_count+1)
+                TmpScript:AddActionUnordered(round(previous_action.at + i*100), easeInOutCubic(previous_action.pos, action.pos, progress))
+            end
+        end
+        previous_action = action
+    end
+    generated = generated + #TmpScript.actions
+    SetProgress(n / (iterations*2))
+end
+print(string.format("easing: %d actions in %.1f ms", generated, (os.clock() - startTime) * 1000.0))
+
+-- one hour sine wave with a point every frame
+-- same loop as examples/wave.lua
+local frameTime = FrameTimeMs > 0 and FrameTimeMs or (1000.0/60.0)
+startTime = os.clock()
+generated = 0
+for n=1, iterations do
+    local TmpScript = Funscript:new()
+    for ms=0, 60*60*1000, frameTime do
+        local pos = round(0.5*(1.0 + math.sin(2.0 * math.pi * 0.75 * (ms/1000.0))) * 100.0)
+        TmpScript:AddActionUnordered(round(ms), pos, false)
+    end
+    generated = generated + #TmpScript.actions
+    SetProgress(0.5 + n / (iterations*2))
+end
+print(string.format("wave: %d actions in %.1f ms", generated, (os.clock() - startTime) * 1000.0))
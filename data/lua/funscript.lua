@@ -166,4 +166,51 @@ end
 -- linear interpolation
 function lerp(start_val, end_val, t) 
    return start_val * (1-t) + end_val * t 
-end
\ No newline at end of file
+end
+
+-- ============
+-- == LuaJIT ==
+-- ============
+-- when OFS was built with LuaJIT the actions of every loaded script are also
+-- available as a C array through the ffi. looping over the buffer doesn't create
+-- a table per action and can be compiled by the jit.
+if jit then
+   local ffi = require("ffi")
+   ffi.cdef[[
+      typedef struct { int32_t at; int16_t pos; uint16_t flags; } OFS_Action;
+   ]]
+
+   ActionSelected = 0x1 -- flag for selected actions in OFS_Action.flags
+
+   -- returns the actions as they were when the script started & the action count
+   -- the buffer is zero indexed buffer[0] ... buffer[count-1]
+   function Funscript:ReadBuffer()
+      local ptr, count = OFS_ActionBuffer(self.bufferIdx)
+      return ffi.cast("OFS_Action*", ptr), count
+   end
+
+   -- resizes the buffer to count actions & returns it
+   -- existing actions are kept, new actions are initialized to at = 0, pos = 0
+   -- pointers returned by ReadBuffer are invalid after calling this.
+   -- once this was called OFS takes the result from the buffer and ignores self.actions
+   function Funscript:WriteBuffer(count)
+      return ffi.cast("OFS_Action*", OFS_WriteActionBuffer(self.bufferIdx, count))
+   end
+
+   -- fills self.actions from the buffer
+   function Funscript:LoadFromBuffer()
+      local buffer, count = self:ReadBuffer()
+      for i = 0, count - 1 do
+         local action = buffer[i]
+         self:AddActionUnordered(action.at, action.pos, bit.band(action.flags, ActionSelected) ~= 0)
+      end
+   end
+
+   -- internal use only
+   function LoadScriptsFromBuffers()
+      for i, script in ipairs(LoadedScripts) do
+         script.bufferIdx = i
+         script:LoadFromBuffer()
+      end
+   end
+end
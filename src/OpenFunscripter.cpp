@@ -281,6 +281,7 @@ bool OpenFunscripter::setup()
     keybinds.load(Util::Prefpath("keybinds.json"));
 
     scriptPositions.setup(undoSystem.get());
+    scriptPositions.FrameIndex = &player->getFrameIndex();
     clearLoadedScripts(); // initialized std::vector with one Funscript
 
     scripting = std::make_unique<ScriptingMode>();
@@ -326,6 +327,8 @@ bool OpenFunscripter::setup()
         }
     };
 
+    player->GpuTimer = &gpuTimer;
+
     playerControls.setup();
     playerControls.player = player.get();
 
@@ -1279,6 +1282,10 @@ void OpenFunscripter::new_frame() noexcept
     glClearColor(0.1f, 0.1f, 0.1f, 1.f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+    // only measure while someone looks at the results
+    gpuTimer.Enabled = settings->data().show_statistics;
+    gpuTimer.NewFrame();
+
     // Start the Dear ImGui frame
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplSDL2_NewFrame(window);
@@ -1289,6 +1296,8 @@ void OpenFunscripter::new_frame() noexcept
 void OpenFunscripter::render() noexcept
 {
     ImGui::Render();
+    scriptPositions.RenderCachedLanes();
+    gpuTimer.Begin(OFS_GpuTimer::Ui);
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
     // Update and Render additional Platform Windows
     // (Platform functions may change the current OpenGL context, so we save/restore it to make it easier to paste this code elsewhere.
@@ -1302,6 +1311,7 @@ void OpenFunscripter::render() noexcept
         ImGui::RenderPlatformWindowsDefault();
         SDL_GL_MakeCurrent(backup_current_window, backup_current_context);
     }
+    gpuTimer.End(OFS_GpuTimer::Ui);
 }
 
 void OpenFunscripter::process_events() noexcept
@@ -1309,6 +1319,7 @@ void OpenFunscripter::process_events() noexcept
     SDL_Event event;
     while (SDL_PollEvent(&event))
     {
+        frameScheduler.Activity(SDL_GetTicks());
         ImGui_ImplSDL2_ProcessEvent(&event);
         switch (event.type) {
         case SDL_QUIT:
@@ -1328,8 +1339,23 @@ void OpenFunscripter::process_events() noexcept
     }
 }
 
+bool OpenFunscripter::isAnimating() noexcept
+{
+    // everything else wakes the loop through an event
+    auto& io = ImGui::GetIO();
+    return !player->isPaused()
+        || tcode.IsRunning()
+        || ControllerInput::AnyButtonHeld()
+        || ImGui::IsAnyMouseDown()
+        || player->isExportingFrames()
+        // blinking text cursor
+        || io.WantTextInput;
+}
+
 void OpenFunscripter::FunscriptChanged(SDL_Event& ev) noexcept
 {
+    auto& changed = ActiveFunscript()->LastChange();
+    timelineGradientChange.Extend(changed.fromMs, changed.toMs);
     updateTimelineGradient = true;
 }
 
@@ -1384,7 +1410,7 @@ void OpenFunscripter::MpvPlayPauseChange(SDL_Event& ev) noexcept
     {
         std::vector<std::weak_ptr<const Funscript>> scripts;
         scripts.assign(LoadedFunscripts.begin(), LoadedFunscripts.end());
-        tcode.play(player->getCurrentPositionMsInterp(), scripts);
+        tcode.play(&player->getClock(), scripts);
     }
 }
 
@@ -1396,8 +1422,6 @@ void OpenFunscripter::update() noexcept {
     if (AutoBackup && player->isPaused()) {
         autoBackup();
     }
-
-    tcode.sync(player->getCurrentPositionMsInterp(), player->getSpeed());
 }
 
 void OpenFunscripter::autoBackup() noexcept
@@ -1465,6 +1489,9 @@ void OpenFunscripter::autoBackup() noexcept
 void OpenFunscripter::step() noexcept {
 
     process_events();
+    // single shots from other threads. this has to happen outside of the imgui frame
+    events->ProcessTasks();
+    player->latchClock();
     update();
     new_frame();
     {
@@ -1494,7 +1521,10 @@ void OpenFunscripter::step() noexcept {
 
         if (updateTimelineGradient) {
             updateTimelineGradient = false;
-            OFS::UpdateHeatmapGradient(player->getDuration()*1000.f, playerControls.TimelineGradient, ActiveFunscript()->Actions());
+            timelineHeatmap.Update(player->getDuration()*1000.f, playerControls.TimelineGradient, ActiveFunscript()->Actions(),
+                timelineGradientChange.fromMs, timelineGradientChange.toMs);
+            timelineGradientChange = Funscript::ChangedInterval();
+            playerControls.TimelineGradientChanged();
         }
 
 
@@ -1627,16 +1657,16 @@ int OpenFunscripter::run() noexcept
     setupDefaultLayout(false);
     render();
     while (!exit_app) {
-        const int32_t maxFrameTicks = std::round(1000.0 / settings->data().framerateLimit);
-        auto tickStart = SDL_GetTicks();
+        frameScheduler.BeginFrame();
         step();
-        while (!settings->data().vsync && SDL_GetTicks() - tickStart < maxFrameTicks) { }
+        frameScheduler.EndFrame(isAnimating(), settings->data().vsync, settings->data().framerateLimit);
     }
 	return 0;
 }
 
 void OpenFunscripter::shutdown() noexcept
 {
+    gpuTimer.Shutdown();
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplSDL2_Shutdown();
     ImGui::DestroyContext();
@@ -1796,44 +1826,15 @@ void OpenFunscripter::saveScripts() noexcept
 
 void OpenFunscripter::saveHeatmap(const char* path, int width, int height)
 {
-    SDL_Surface* surface;
-    Uint32 rmask, gmask, bmask, amask;
-
-    // same order as ImGui U32 colors
-    rmask = 0x000000ff;
-    gmask = 0x0000ff00;
-    bmask = 0x00ff0000;
-    amask = 0xff000000;
-
-    surface = SDL_CreateRGBSurface(0, width, height, 32, rmask, gmask, bmask, amask);
-    if (surface == NULL) {
-        LOGF_ERROR("SDL_CreateRGBSurface() failed: %s", SDL_GetError());
-        return;
-    }
-
-    // not sure if this is always false, on every platform
-    const bool mustLock = SDL_MUSTLOCK(surface); 
-    if (mustLock) { SDL_LockSurface(surface); }
+    if (width <= 0 || height <= 0) return;
 
-    SDL_Rect rect{ 0 };
-    rect.h = height;
-
-    const float relStep = 1.f / width;
-    rect.w = 1;
-    float relPos = 0.f;
-    
-    ImColor color;
-    color.Value.w = 1.f;
-    while (relPos <= 1.f) {
-        rect.x = std::round(relPos * width);
-        playerControls.TimelineGradient.computeColorAt(relPos, &color.Value.x);
-        SDL_FillRect(surface, &rect, ImGui::ColorConvertFloat4ToU32(color));
-        relPos += relStep;
-    }
-    Util::SavePNG(path, surface->pixels, surface->w, surface->h, 4, true);
-
-    if (mustLock) { SDL_UnlockSurface(surface); }
-    SDL_FreeSurface(surface);
+    // same raster as the timeline texture, every row is the same
+    std::vector<uint32_t> pixels((size_t)width * height);
+    playerControls.TimelineGradient.rasterize(pixels.data(), width);
+    for (int y = 1; y < height; y++) {
+        std::copy(pixels.begin(), pixels.begin() + width, pixels.begin() + (size_t)y * width);
+    }
+    Util::SavePNG(path, pixels.data(), width, height, 4, true);
 }
 
 void OpenFunscripter::removeAction(FunscriptAction action) noexcept
@@ -2222,6 +2223,51 @@ void OpenFunscripter::ShowMainMenuBar() noexcept
                 Util::CreateDirectories(screenshot_dir);
                 Util::OpenFileExplorer(screenshot_dir.c_str());
             }
+            if (ImGui::BeginMenu("Export frames", player->isLoaded())) {
+                auto screenshot_dir = Util::Prefpath("screenshot");
+                auto& script = ActiveFunscript();
+                if (player->isExportingFrames()) {
+                    char tmp[64];
+                    stbsp_snprintf(tmp, sizeof(tmp), "Cancel (%zu/%zu)", player->exportedFrameCount(), player->totalExportFrameCount());
+                    if (ImGui::MenuItem(tmp)) {
+                        player->cancelFrameExport();
+                    }
+                }
+                else {
+                    auto actionTimes = [](const std::vector<FunscriptAction>& actions) {
+                        std::vector<int32_t> times;
+                        times.reserve(actions.size());
+                        for (auto& action : actions) { times.emplace_back(action.at); }
+                        return times;
+                    };
+                    if (ImGui::MenuItem("At selected actions", NULL, false, script->HasSelection())) {
+                        player->exportFrames(actionTimes(script->Selection()), screenshot_dir, player->settings.exportFormat);
+                    }
+                    if (ImGui::MenuItem("At all actions", NULL, false, !script->Actions().empty())) {
+                        player->exportFrames(actionTimes(script->Actions()), screenshot_dir, player->settings.exportFormat);
+                    }
+                    if (ImGui::MenuItem("Every frame of the selection", NULL, false, script->Selection().size() > 1)) {
+                        std::vector<int32_t> times;
+                        int32_t fromMs = script->Selection().front().at;
+                        int32_t toMs = script->Selection().back().at;
+                        auto& frames = player->getFrameIndex();
+                        if (!frames.Empty()) {
+                            for (int64_t frame = frames.FrameAt(fromMs / 1000.0), last = frames.FrameAt(toMs / 1000.0); frame <= last; frame++) {
+                                times.emplace_back(frames.FrameTimeMs(frame));
+                            }
+                        }
+                        else {
+                            for (double timeMs = fromMs; timeMs <= toMs; timeMs += player->getFrameTimeMs()) {
+                                times.emplace_back(timeMs);
+                            }
+                        }
+                        player->exportFrames(std::move(times), screenshot_dir, player->settings.exportFormat);
+                    }
+                    ImGui::Separator();
+                    ImGui::Combo("Format", (int*)&player->settings.exportFormat, "PNG\0JPEG\0\0");
+                }
+                ImGui::EndMenu();
+            }
 
             ImGui::Separator();
 
@@ -2438,6 +2484,9 @@ void OpenFunscripter::ShowMainMenuBar() noexcept
             if (ImGui::BeginMenu("DEBUG ONLY")) {
                 if (ImGui::MenuItem("ImGui", NULL, &DebugMetrics)) {}
                 if (ImGui::MenuItem("ImGui Demo", NULL, &DebugDemo)) {}
+                if (ImGui::MenuItem("Benchmark heatmap")) { OFS::FunscriptHeatmap::Benchmark(); }
+                if (ImGui::MenuItem("Benchmark timeline culling")) { ScriptTimeline::BenchmarkCulling(); }
+                if (ImGui::MenuItem("Benchmark event dispatch")) { EventSystem::Benchmark(); }
                 ImGui::EndMenu();
             }
             ImGui::EndMenu();
@@ -2731,6 +2780,16 @@ void OpenFunscripter::ShowStatisticsWindow(bool* open) noexcept
         }
     }
 
+    ImGui::Separator();
+    frameScheduler.ShowReport();
+    ImGui::Text("Playback clock error: %.2f ms", player->getClock().LastError() * 1000.0);
+    ImGui::Text("Playback rate correction: %.3f%%", player->getClock().RateCorrection() * 100.0);
+    ImGui::Separator();
+    gpuTimer.ShowTimings();
+    auto tasks = events->TaskMetrics();
+    ImGui::Text("Main thread tasks: %zu queued, %zu peak", tasks.depth, tasks.peakDepth);
+    ImGui::Text("  %llu processed, %llu overflowed", (unsigned long long)tasks.processed, (unsigned long long)tasks.overflowed);
+
     ImGui::End();
 
 }
@@ -28,6 +28,8 @@
 #include "OFS_Events.h"
 #include "OFS_VideoplayerControls.h"
 #include "OFS_TCode.h"
+#include "FunscriptHeatmap.h"
+#include "OFS_FrameScheduler.h"
 
 #include <memory>
 #include <array>
@@ -51,10 +53,15 @@ private:
 	std::chrono::system_clock::time_point last_backup;
 
 	bool updateTimelineGradient = false;
+	Funscript::ChangedInterval timelineGradientChange;
+	OFS::FunscriptHeatmap timelineHeatmap;
 	char tmp_buf[2][32];
 
 	int32_t ActiveFunscriptIdx = 0;
 
+	OFS_FrameScheduler frameScheduler;
+	OFS_GpuTimer gpuTimer;
+
 	void register_bindings();
 
 	void update() noexcept;
@@ -65,6 +72,8 @@ private:
 	bool load_fonts(const char* font_override = nullptr) noexcept;
 	bool imgui_setup() noexcept;
 	void process_events() noexcept;
+	// true if the next frame can't wait for an event
+	bool isAnimating() noexcept;
 
 	void FunscriptChanged(SDL_Event& ev) noexcept;
 
@@ -143,7 +143,6 @@ void ScriptingMode::PreviousFrame() noexcept
 void ScriptingMode::update() noexcept
 {
     impl->update();
-    OpenFunscripter::ptr->scriptPositions.overlay->update();
 }
 
 // dynamic top injection
@@ -410,7 +409,11 @@ void RecordingImpl::update() noexcept
     auto app = OpenFunscripter::ptr;
     if (recordingActive) {
         uint32_t frameEstimate = app->player->getCurrentFrameEstimate();
-        app->scriptPositions.RecordingBuffer[frameEstimate] = std::move(FunscriptAction(app->player->getCurrentPositionMs(), currentPos));
+        auto& frames = app->player->getFrameIndex();
+        int32_t atMs = frames.Empty() ? app->player->getCurrentPositionMs() : frames.FrameTimeMs(frameEstimate);
+        if (frameEstimate < app->scriptPositions.RecordingBuffer.size()) {
+            app->scriptPositions.RecordingBuffer[frameEstimate] = std::move(FunscriptAction(atMs, currentPos));
+        }
         app->simulator.positionOverride = currentPos;
     }
     else if (recordingJustStarted) {
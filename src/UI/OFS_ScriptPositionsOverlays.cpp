@@ -58,6 +58,19 @@ void FrameOverlay::DrawScriptPositionContent(const OverlayDrawingCtx& ctx) noexc
     BaseOverlay::DrawScriptLabel(ctx);
 }
 
+void FrameOverlay::AddContentKey(OFS_TimelineLaneCache::ContentKey& key) noexcept
+{
+    auto app = OpenFunscripter::ptr;
+    key.Add(app->player->getFrameTimeMs());
+    key.Add(app->player->getFps());
+    // the out of sync line
+    bool outOfSyncLine = app->player->isPaused() || app->player->getSpeed() <= 0.1;
+    key.Add(outOfSyncLine);
+    if (outOfSyncLine) {
+        key.Add(app->player->getRealCurrentPositionMs());
+    }
+}
+
 void FrameOverlay::nextFrame() noexcept
 {
     OpenFunscripter::ptr->player->nextFrame();
@@ -70,11 +83,19 @@ void FrameOverlay::previousFrame() noexcept
 
 float FrameOverlay::steppingIntervalBackward(float fromMs) noexcept
 {
+    auto& frames = OpenFunscripter::ptr->player->getFrameIndex();
+    if (!frames.Empty()) {
+        return frames.FrameTimeMs(frames.FrameAt(fromMs / 1000.0) - 1) - fromMs;
+    }
     return -timeline->frameTimeMs;
 }
 
 float FrameOverlay::steppingIntervalForward(float fromMs) noexcept
 {
+    auto& frames = OpenFunscripter::ptr->player->getFrameIndex();
+    if (!frames.Empty()) {
+        return frames.FrameTimeMs(frames.FrameAt(fromMs / 1000.0) + 1) - fromMs;
+    }
     return timeline->frameTimeMs;
 }
 
@@ -163,6 +184,16 @@ void TempoOverlay::DrawScriptPositionContent(const OverlayDrawingCtx& ctx) noexc
     }
 }
 
+void TempoOverlay::AddContentKey(OFS_TimelineLaneCache::ContentKey& key) noexcept
+{
+    auto app = OpenFunscripter::ptr;
+    auto& tempo = app->ActiveFunscript()->Userdata<OFS_ScriptSettings>().tempoSettings;
+    key.Add(tempo.bpm);
+    key.Add(tempo.beat_offset_seconds);
+    key.Add(tempo.multiIDX);
+    key.Add(app->settings->data().default_font_size);
+}
+
 static int32_t GetNextPosition(float beatTimeMs, float currentTimeMs, float beatOffset) noexcept
 {
     float beatIdx = ((currentTimeMs - (beatOffset * 1000.f)) / beatTimeMs);
@@ -57,6 +57,7 @@ public:
 		: BaseOverlay(timeline) {}
 	virtual void DrawSettings() noexcept override;
 	virtual void DrawScriptPositionContent(const OverlayDrawingCtx& ctx) noexcept override;
+	virtual void AddContentKey(OFS_TimelineLaneCache::ContentKey& key) noexcept override;
 	virtual void nextFrame() noexcept override;
 	virtual void previousFrame() noexcept override;
 
@@ -71,6 +72,7 @@ public:
 	FrameOverlay(class ScriptTimeline* timeline)
 		: BaseOverlay(timeline) {}
 	virtual void DrawScriptPositionContent(const OverlayDrawingCtx& ctx) noexcept override;
+	virtual void AddContentKey(OFS_TimelineLaneCache::ContentKey& key) noexcept override;
 	virtual void nextFrame() noexcept override;
 	virtual void previousFrame() noexcept override;
 
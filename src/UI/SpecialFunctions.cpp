@@ -10,6 +10,7 @@
 #include <filesystem>
 #include <sstream>
 #include <unordered_set>
+#include <cstddef>
 
 #include "SDL_thread.h"
 #include "SDL_atomic.h"
@@ -234,8 +235,26 @@ struct LuaThread {
         std::unordered_set<FunscriptAction, FunscriptActionHashfunction> selection;
     };
     std::vector<ScriptOutput> outputs;
+#ifdef OFS_LUAJIT
+    // raw action buffers which get exposed through the ffi
+    // the layout has to match OFS_Action in funscript.lua
+    struct ActionBuffer {
+        std::vector<FunscriptAction> actions;
+        bool written = false;
+    };
+    std::vector<ActionBuffer> buffers;
+#endif
 };
 
+#ifdef OFS_LUAJIT
+static_assert(sizeof(FunscriptAction) == 8
+    && offsetof(FunscriptAction, at) == 0
+    && offsetof(FunscriptAction, pos) == 4
+    && offsetof(FunscriptAction, flags) == 6, "FunscriptAction doesn't match OFS_Action");
+// flag in OFS_Action.flags which marks selected actions. only used inside of lua buffers
+static constexpr uint16_t LuaActionSelected = 0x1;
+#endif
+
 static LuaThread Thread;
 static std::string LuaConsoleBuffer;
 static SDL_SpinLock SpinLock = 0;
@@ -358,7 +377,7 @@ void CustomLua::resetVM() noexcept
     SDL_AtomicLock(&SpinLock);
     LuaConsoleBuffer.clear();
     SDL_AtomicUnlock(&SpinLock);
-    WriteToConsole("Running " LUA_VERSION " ...");
+    WriteToConsole("Running " OFS_LUA_VERSION " ...");
     
     if (Thread.L != nullptr) {
         lua_close(Thread.L);
@@ -527,6 +546,33 @@ void CustomLua::resetVM() noexcept
         lua_pushcfunction(Thread.L, LuaSetSettings);
         lua_setglobal(Thread.L, "SetSettings");
 
+#ifdef OFS_LUAJIT
+        auto LuaActionBuffer = [](lua_State* L) -> int {
+            int32_t idx = luaL_checkinteger(L, 1) - 1; // !!! lua indexing starts at 1 !!!
+            if (idx < 0 || idx >= Thread.buffers.size()) { return luaL_error(L, "invalid action buffer index %d", idx + 1); }
+            auto& buffer = Thread.buffers[idx];
+            lua_pushlightuserdata(L, buffer.actions.data());
+            lua_pushinteger(L, buffer.actions.size());
+            return 2;
+        };
+        lua_pushcfunction(Thread.L, LuaActionBuffer);
+        lua_setglobal(Thread.L, "OFS_ActionBuffer");
+
+        auto LuaWriteActionBuffer = [](lua_State* L) -> int {
+            int32_t idx = luaL_checkinteger(L, 1) - 1; // !!! lua indexing starts at 1 !!!
+            int32_t count = luaL_checkinteger(L, 2);
+            if (idx < 0 || idx >= Thread.buffers.size()) { return luaL_error(L, "invalid action buffer index %d", idx + 1); }
+            if (count < 0) { return luaL_error(L, "invalid action count %d", count); }
+            auto& buffer = Thread.buffers[idx];
+            buffer.actions.resize(count, FunscriptAction(0, 0));
+            buffer.written = true;
+            lua_pushlightuserdata(L, buffer.actions.data());
+            return 1;
+        };
+        lua_pushcfunction(Thread.L, LuaWriteActionBuffer);
+        lua_setglobal(Thread.L, "OFS_WriteActionBuffer");
+#endif
+
         auto initScript = Util::Resource("lua/funscript.lua");
         
         int result = LuaDoFile(Thread.L, initScript.c_str());
@@ -553,6 +599,28 @@ void CustomLua::resetVM() noexcept
         Thread.ClipboardCount = app->FunscriptClipboard().size();
 
         std::stringstream builder;
+#ifdef OFS_LUAJIT
+        // instead of generating a huge setup script the actions get copied into
+        // buffers which are turned into lua tables by LoadFromBuffer in funscript.lua
+        Thread.buffers.clear();
+        Thread.buffers.resize(app->LoadedFunscripts.size());
+        for (int i = 0; i < app->LoadedFunscripts.size(); i++) {
+            auto& loadedScript = app->LoadedFunscripts[i];
+            auto& buffer = Thread.buffers[i].actions;
+            buffer = loadedScript->Actions();
+            auto& selection = loadedScript->Selection();
+            // both are sorted by time
+            auto selectionIt = selection.begin();
+            for (auto& action : buffer) {
+                action.flags = ActionFlags::None;
+                while (selectionIt != selection.end() && selectionIt->at < action.at) { ++selectionIt; }
+                if (selectionIt != selection.end() && *selectionIt == action) {
+                    action.flags |= LuaActionSelected;
+                }
+            }
+        }
+        index += actions.size();
+#else
         for (auto&& action : actions) {
             stbsp_snprintf(tmp, sizeof(tmp), "CurrentScript:AddActionUnordered(%d, %d, %s)\n",
                 action.at,
@@ -568,6 +636,7 @@ void CustomLua::resetVM() noexcept
                 builder << tmp;
             }
         }
+#endif
         for (auto&& action : app->FunscriptClipboard()) {
             stbsp_snprintf(tmp, sizeof(tmp), "Clipboard:AddActionUnordered(%d, %d, false)\n",
                 action.at,
@@ -600,7 +669,7 @@ void CustomLua::resetVM() noexcept
             // i+1 because lua indexing starts at 1 !!!
             stbsp_snprintf(tmp, sizeof(tmp), "LoadedScripts[%d].title = \"%s\"\n", i+1, loadedScript->metadata.title.c_str());
             builder << tmp;
-
+#ifndef OFS_LUAJIT
             for (auto&& action : loadedScript->Actions()) {
                 stbsp_snprintf(tmp, sizeof(tmp), "LoadedScripts[%d]:AddActionUnordered(%d, %d, %s)\n",
                     i + 1, // !!! lua indexing starts at 1 !!!
@@ -610,7 +679,11 @@ void CustomLua::resetVM() noexcept
                 );
                 builder << tmp;
             }
+#endif
         }
+#ifdef OFS_LUAJIT
+        builder << "LoadScriptsFromBuffers()\n";
+#endif
 
 
         stbsp_snprintf(tmp, sizeof(tmp), "CurrentScript.title=\"%s\"\n", script->metadata.title.c_str());
@@ -670,6 +743,21 @@ bool CollectScriptOutputs(LuaThread& thread, lua_State* L) noexcept
         lua_rawgeti(L, -1, i); // push script
         CHECK_OR_FAIL(lua_istable(L, -1));
 
+#ifdef OFS_LUAJIT
+        if (thread.buffers[i - 1].written) {
+            // the script wrote it's result directly into the buffer
+            for (auto action : thread.buffers[i - 1].actions) {
+                bool isSelected = action.flags & LuaActionSelected;
+                action.pos = Util::Clamp<int16_t>(action.pos, 0, 100);
+                action.at = std::max(action.at, 0);
+                action.flags = ActionFlags::None;
+                currentScript.actions.insert(action);
+                if (isSelected) { currentScript.selection.insert(action); }
+            }
+            lua_pop(L, 1); // pop script
+            continue;
+        }
+#endif
         lua_getfield(L, -1, "actions"); // push actions array
         CHECK_OR_FAIL(lua_istable(L, -1));
 
@@ -877,7 +965,7 @@ void CustomLua::DrawUI() noexcept
     ImGui::Spacing();
     
     if (ImGui::Button("Open Lua documentation", ImVec2(-1.f, 0.f))) {
-        Util::OpenUrl("https://www.lua.org/manual/5.4/");
+        Util::OpenUrl(OFS_LUA_MANUAL_URL);
     }
 
     ImGui::BeginChild("ConsoleBuffer", ImVec2(-1.f, 200.f));
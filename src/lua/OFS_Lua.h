@@ -1,6 +1,23 @@
 #pragma once
 
+#ifdef OFS_LUAJIT
+// LuaJIT is a C library, lua.hpp wraps the headers in extern "C"
+#include "lua.hpp"
+#include "luajit.h"
+
+// LuaJIT implements the 5.1 api
+#if LUA_VERSION_NUM < 502
+#define lua_rawlen lua_objlen
+#endif
+
+#define OFS_LUA_VERSION LUAJIT_VERSION " (" LUA_VERSION ")"
+#define OFS_LUA_MANUAL_URL "https://www.lua.org/manual/5.1/"
+#else
 // we're compiling and linking lua as c++ which is why no extern "C" is needed here
 #include "lua.h"
 #include "lauxlib.h"
 #include "lualib.h"
+
+#define OFS_LUA_VERSION LUA_VERSION
+#define OFS_LUA_MANUAL_URL "https://www.lua.org/manual/5.4/"
+#endif